@@ -0,0 +1,44 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file cache.cpp
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/09/02 20:41
+ * @brief
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#include "cache.h"
+#include <bit>
+
+namespace astro {
+    constexpr std::size_t CACHE_SHARDS = 16;
+
+    constexpr std::size_t CACHE_WAYS = 8;
+
+    namespace {
+        // splitmix64的末段混合
+        std::uint64_t mix(std::uint64_t x) {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ULL;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebULL;
+            x ^= x >> 31;
+
+            return x;
+        }
+    }  // namespace
+
+    std::uint64_t hashKey(const EpochKey& key) {
+        auto hash = mix(std::bit_cast<std::uint64_t>(key.tdb_jd_C));
+
+        hash = mix(hash ^ std::bit_cast<std::uint64_t>(key.precision));
+
+        return mix(hash ^ key.variant);
+    }
+}  // namespace astro
@@ -0,0 +1,127 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file cache.h
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/09/02 20:41
+ * @brief
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#ifndef CACHE_H
+#define CACHE_H
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+namespace astro {
+    struct EpochKey {
+        double tdb_jd_C;
+        ///< 截断精度(角秒)
+        double precision;
+        ///< 区分同一历元的不同求值方式，如Component
+        std::uint32_t variant;
+
+        bool operator==(const EpochKey&) const = default;
+    };
+
+    struct CacheStatistics {
+        std::uint64_t hits{};
+        std::uint64_t misses{};
+        ///< 写入时覆盖了其他键的次数
+        std::uint64_t evictions{};
+        ///< 槽位正被其他线程写入而放弃的写入次数
+        std::uint64_t contended{};
+    };
+
+    ///< 默认分片数，各分片的统计计数独占缓存行，避免线程间伪共享
+    extern const std::size_t CACHE_SHARDS;
+
+    ///< 组相联的路数，同一组内按轮转替换
+    extern const std::size_t CACHE_WAYS;
+
+    ///< 由键的位模式求64位哈希，高位选分片，低位选组
+    std::uint64_t hashKey(const EpochKey& key);
+
+    /**
+     * @brief 以历元为键的并发记忆化缓存，容量有界
+     * @details 按键的哈希分片，分片内为CACHE_WAYS路组相联的定长槽位，满时按轮转覆盖。每个槽位带序号锁(seqlock):
+     *          读者不加锁，读取前后序号相同且为偶数才接受；写者以CAS把序号置为奇数后写入，CAS失败说明有其他线程正在写入，
+     *          直接放弃本次写入。键与值以64位字存入原子变量，读写并发时不存在数据竞争
+     * @note 同一个键可能被多个线程同时求值，结果相同，只会多算几次
+     * */
+    template<typename Value>
+        requires std::is_trivially_copyable_v<Value>
+    class EpochCache {
+    public:
+        ///< capacity为槽位总数的下限，向上取整为分片数·路数·2的幂
+        explicit EpochCache(std::size_t capacity, std::size_t shards = CACHE_SHARDS);
+
+        EpochCache(const EpochCache&) = delete;
+
+        EpochCache& operator=(const EpochCache&) = delete;
+
+        [[nodiscard]] std::optional<Value> find(const EpochKey& key) const;
+
+        void insert(const EpochKey& key, const Value& value);
+
+        ///< 命中则返回缓存值，否则调用compute()求值并写入
+        template<typename Func>
+        Value get(const EpochKey& key, const Func& compute);
+
+        [[nodiscard]] CacheStatistics statistics() const;
+
+        [[nodiscard]] std::size_t capacity() const noexcept;
+
+        ///< 清空所有槽位与统计，不能与读写并发调用
+        void clear();
+
+    private:
+        static constexpr std::size_t KEY_WORDS   = 3;
+        static constexpr std::size_t VALUE_WORDS = (sizeof(Value) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+        struct Slot {
+            ///< 奇数表示正在写入
+            std::atomic<std::uint64_t> sequence{};
+            ///< 第三个字为variant + 1，0表示空槽位
+            std::array<std::atomic<std::uint64_t>, KEY_WORDS> key{};
+            std::array<std::atomic<std::uint64_t>, VALUE_WORDS> value{};
+        };
+
+        struct alignas(64) Shard {
+            std::atomic<std::uint64_t> hits{};
+            std::atomic<std::uint64_t> misses{};
+            std::atomic<std::uint64_t> evictions{};
+            std::atomic<std::uint64_t> contended{};
+            ///< 轮转替换的计数
+            std::atomic<std::uint64_t> clock{};
+        };
+
+        std::size_t shardCount;
+        std::size_t setCount;
+
+        std::unique_ptr<Shard[]> shards;
+        std::unique_ptr<Slot[]> slots;
+
+        static std::array<std::uint64_t, KEY_WORDS> keyWords(const EpochKey& key);
+
+        [[nodiscard]] std::size_t shardIndex(std::uint64_t hash) const noexcept;
+
+        ///< 该键所在组的第一个槽位
+        [[nodiscard]] std::size_t setBegin(std::uint64_t hash) const noexcept;
+    };
+}  // namespace astro
+
+#include "cache.hpp"
+
+#endif  // CACHE_H
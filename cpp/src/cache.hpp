@@ -0,0 +1,187 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file cache.hpp
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/09/02 20:41
+ * @brief
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#ifndef CACHE_HPP
+#define CACHE_HPP
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace astro {
+    template<typename Value>
+        requires std::is_trivially_copyable_v<Value>
+    EpochCache<Value>::EpochCache(const std::size_t capacity, const std::size_t shards) : shardCount(std::max<std::size_t>(shards, 1)) {
+        if (!capacity) throw std::invalid_argument("EpochCache: capacity must be positive");
+
+        // 组数取2的幂，按哈希低位取模
+        setCount = std::bit_ceil((capacity + shardCount * CACHE_WAYS - 1) / (shardCount * CACHE_WAYS));
+
+        this->shards = std::make_unique<Shard[]>(shardCount);
+        slots        = std::make_unique<Slot[]>(shardCount * setCount * CACHE_WAYS);
+    }
+
+    template<typename Value>
+        requires std::is_trivially_copyable_v<Value>
+    std::array<std::uint64_t, EpochCache<Value>::KEY_WORDS> EpochCache<Value>::keyWords(const EpochKey& key) {
+        return {std::bit_cast<std::uint64_t>(key.tdb_jd_C), std::bit_cast<std::uint64_t>(key.precision), std::uint64_t{key.variant} + 1};
+    }
+
+    template<typename Value>
+        requires std::is_trivially_copyable_v<Value>
+    std::size_t EpochCache<Value>::shardIndex(const std::uint64_t hash) const noexcept {
+        return (hash >> 32) % shardCount;
+    }
+
+    template<typename Value>
+        requires std::is_trivially_copyable_v<Value>
+    std::size_t EpochCache<Value>::setBegin(const std::uint64_t hash) const noexcept {
+        return (shardIndex(hash) * setCount + (hash & (setCount - 1))) * CACHE_WAYS;
+    }
+
+    template<typename Value>
+        requires std::is_trivially_copyable_v<Value>
+    std::optional<Value> EpochCache<Value>::find(const EpochKey& key) const {
+        const auto hash  = hashKey(key);
+        const auto words = keyWords(key);
+        auto& shard      = shards[shardIndex(hash)];
+
+        for (std::size_t way{}; way < CACHE_WAYS; ++way) {
+            const auto& slot = slots[setBegin(hash) + way];
+
+            const auto before = slot.sequence.load(std::memory_order_acquire);
+
+            if (before & 1) continue;
+
+            bool match = true;
+
+            for (std::size_t i{}; i < KEY_WORDS; ++i) match = match && slot.key[i].load(std::memory_order_relaxed) == words[i];
+
+            if (!match) continue;
+
+            std::array<std::uint64_t, VALUE_WORDS> buffer;
+
+            for (std::size_t i{}; i < VALUE_WORDS; ++i) buffer[i] = slot.value[i].load(std::memory_order_relaxed);
+
+            // 读取的键与值须早于第二次读取序号
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot.sequence.load(std::memory_order_relaxed) != before) continue;
+
+            Value value;
+            std::memcpy(&value, buffer.data(), sizeof(Value));
+
+            shard.hits.fetch_add(1, std::memory_order_relaxed);
+
+            return value;
+        }
+
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+
+        return std::nullopt;
+    }
+
+    template<typename Value>
+        requires std::is_trivially_copyable_v<Value>
+    void EpochCache<Value>::insert(const EpochKey& key, const Value& value) {
+        const auto hash  = hashKey(key);
+        const auto words = keyWords(key);
+        auto& shard      = shards[shardIndex(hash)];
+
+        // 已有该键或空槽位时优先使用，否则按轮转替换
+        std::size_t victim = CACHE_WAYS;
+
+        for (std::size_t way{}; way < CACHE_WAYS && victim == CACHE_WAYS; ++way) {
+            const auto& candidate = slots[setBegin(hash) + way];
+
+            bool reusable = true;
+
+            for (std::size_t i{}; i < KEY_WORDS; ++i) reusable = reusable && candidate.key[i].load(std::memory_order_relaxed) == words[i];
+
+            if (reusable || !candidate.key[KEY_WORDS - 1].load(std::memory_order_relaxed)) victim = way;
+        }
+
+        const bool evicting = victim == CACHE_WAYS;
+
+        if (evicting) victim = shard.clock.fetch_add(1, std::memory_order_relaxed) % CACHE_WAYS;
+
+        auto& slot = slots[setBegin(hash) + victim];
+
+        auto sequence = slot.sequence.load(std::memory_order_relaxed);
+
+        if ((sequence & 1) || !slot.sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            shard.contended.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::array<std::uint64_t, VALUE_WORDS> buffer{};
+        std::memcpy(buffer.data(), &value, sizeof(Value));
+
+        for (std::size_t i{}; i < KEY_WORDS; ++i) slot.key[i].store(words[i], std::memory_order_relaxed);
+
+        for (std::size_t i{}; i < VALUE_WORDS; ++i) slot.value[i].store(buffer[i], std::memory_order_relaxed);
+
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+
+        if (evicting) shard.evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template<typename Value>
+        requires std::is_trivially_copyable_v<Value>
+    template<typename Func>
+    Value EpochCache<Value>::get(const EpochKey& key, const Func& compute) {
+        if (const auto cached = find(key)) return *cached;
+
+        const Value value = compute();
+
+        insert(key, value);
+
+        return value;
+    }
+
+    template<typename Value>
+        requires std::is_trivially_copyable_v<Value>
+    CacheStatistics EpochCache<Value>::statistics() const {
+        CacheStatistics result;
+
+        for (std::size_t i{}; i < shardCount; ++i) {
+            result.hits += shards[i].hits.load(std::memory_order_relaxed);
+            result.misses += shards[i].misses.load(std::memory_order_relaxed);
+            result.evictions += shards[i].evictions.load(std::memory_order_relaxed);
+            result.contended += shards[i].contended.load(std::memory_order_relaxed);
+        }
+
+        return result;
+    }
+
+    template<typename Value>
+        requires std::is_trivially_copyable_v<Value>
+    std::size_t EpochCache<Value>::capacity() const noexcept {
+        return shardCount * setCount * CACHE_WAYS;
+    }
+
+    template<typename Value>
+        requires std::is_trivially_copyable_v<Value>
+    void EpochCache<Value>::clear() {
+        shards = std::make_unique<Shard[]>(shardCount);
+        slots  = std::make_unique<Slot[]>(capacity());
+    }
+}  // namespace astro
+
+#endif  // CACHE_HPP
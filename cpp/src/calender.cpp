@@ -16,61 +16,485 @@
 #include "calender.h"
 #include "constant.h"
 #include "lea.h"
+#include "trig.h"
 #include "utils.h"
 #include "vsop.h"
+#include <algorithm>
 #include <cmath>
+#include <format>
 #include <numbers>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace astro {
-    GeoCoord<double, double, double> solarApparentCoordinate(double tdb_jd_C, const reader::Data& data) {
-        auto trueCoords = vsop::vsop2013(tdb_jd_C, data);
+    namespace {
+        constexpr double DEGREE = std::numbers::pi_v<double> / 180;
+
+        // 由地月系根数求太阳地心黄经的变化率(度/儒略世纪): 开普勒运动中 dν/dt = n(1 + e·cosν)² / (1 - e²)^(3/2)
+        double solarLongitudeRate(const double l, const double k, const double h) {
+            const auto eccentricity        = vsop::calcEccentricity(k, h);
+            const auto perihelionLongitude = vsop::calcPerihelionLongitude(k, h);
+            const auto eccentricAnomaly    = vsop::solveKepler(eccentricity, vsop::calcMeanAnomaly(l, perihelionLongitude));
+            const auto trueAnomaly         = vsop::calcTrueAnomaly(eccentricAnomaly, eccentricity);
+
+            // 地月系平黄经的线性项(弧度/千年)即平均运动
+            const auto meanMotion = vsop::LAMBDA_COEFFICIENTS[2][1] / DEGREE / 10;
+            const auto factor     = 1 + eccentricity * sincos(trueAnomaly).second;
+
+            return meanMotion * factor * factor / std::pow(1 - eccentricity * eccentricity, 1.5);
+        }
+
+        // 黄道J2000上地月系轨道倾角在VSOP2013有效范围内不超过0.01弧度，p、q的误差对黄经的影响不超过其2i倍
+        constexpr double MAX_INCLINATION = 0.01;
+
+        // lightTimeCoord只用于光行时，trueCoord给出光行时修正后的真坐标；rate非空时同时给出视黄经的变化率，复用同一组根数
+        template<typename LightTimeFunc, typename TrueFunc, typename CoefficientsFunc>
+        GeoCoord<double, double, double>
+        solarApparent(double tdb_jd_C, const LightTimeFunc& lightTimeCoord, const TrueFunc& trueCoord, const CoefficientsFunc& coefficients, double* rate = nullptr) {
+            auto trueCoords = lightTimeCoord(tdb_jd_C);
+
+            // 光行时修正，日地距离以AU计，tau以儒略世纪计
+            auto tau = trueCoords.geocentricDistance * AU / LIGHT_SPEED / SECONDS_PER_CENTURY;
+
+            // VSOP给出弧度，以下统一使用度
+            auto travelTimeCorrection = trueCoord(tdb_jd_C - tau);
+            travelTimeCorrection.longitude /= DEGREE;
+            travelTimeCorrection.latitude /= DEGREE;
+
+            const auto [a, l, k, h, q, p]  = coefficients(tdb_jd_C);
+            const auto perihelionLongitude = vsop::calcPerihelionLongitude(k, h) / DEGREE;
+
+            if (rate) *rate = solarLongitudeRate(l, k, h);
+
+            // 光行差修正
+            const auto K = 20.49552;
+
+            auto aberrationFunc = [&](double appLong) -> double {
+                double delta = -K * sincos((appLong - perihelionLongitude) * std::numbers::pi_v<double> / 180).second / 3600;
+
+                return travelTimeCorrection.longitude + delta - appLong;
+            };
+
+            auto initLong          = travelTimeCorrection.longitude;
+            auto apparentLongitude = brent(aberrationFunc, initLong - 0.1, initLong + 0.1, 1e-8, 10);
+
+            auto apparentLatitude =
+                -K * sincos(travelTimeCorrection.latitude * std::numbers::pi_v<double> / 180).first * sincos((apparentLongitude - perihelionLongitude) * std::numbers::pi_v<double> / 180).first / 3600
+                + travelTimeCorrection.latitude;
 
-        // 光行时修正
-        auto tau = trueCoords.geocentricDistance / LIGHT_SPEED;
+            return {travelTimeCorrection.geocentricDistance, apparentLongitude, apparentLatitude};
+        }
 
-        auto travelTimeCorrection = vsop::vsop2013(tdb_jd_C - tau, data);
+        // 月球的光行差修正(度)，返回黄经、黄纬的修正量
+        std::pair<double, double> moonAberration(const double longitude, const double latitude, const double solarAppLong) {
+            const auto k = 20.49552;
 
-        const auto [a, l, k, h, p, q]  = vsop::calcCoefficents<double>(tdb_jd_C, data);
-        const auto perihelionLongitude = vsop::calcPerihelionLongitude(k, h);
+            const auto [sinElongation, cosElongation] = sincos((longitude - solarAppLong) * DEGREE);
+            const auto [sinLatitude, cosLatitude]     = sincos(latitude * DEGREE);
 
-        // 光行差修正
-        const auto K = 20.49552;
+            const auto deltaV = k * cosElongation / cosLatitude / 3600;
+            const auto deltaU = k * sinLatitude * sinElongation / 3600;
 
-        auto aberrationFunc = [&](double appLong) -> double {
-            double delta = -K * std::cos((appLong - perihelionLongitude) * std::numbers::pi_v<double> / 180) / 3600;
+            return {deltaV, deltaU};
+        }
+
+        // distance只用于光行时，无需求黄经、黄纬级数
+        template<typename DistanceFunc, typename TrueFunc>
+        GeoCoord<long double, long double, long double> moonApparent(double tdb_jd_C, const DistanceFunc& distance, const TrueFunc& trueCoord, const double solarAppLong) {
+            // 光行时修正，地月距离以km计
+            auto tau = distance(tdb_jd_C) * 1000 / LIGHT_SPEED / SECONDS_PER_CENTURY;
+
+            auto travelTimeCorrection = trueCoord(tdb_jd_C - tau);
+
+            const auto [deltaV, deltaU] = moonAberration(travelTimeCorrection.longitude, travelTimeCorrection.latitude, solarAppLong);
+
+            return {travelTimeCorrection.geocentricDistance, travelTimeCorrection.longitude + deltaV, travelTimeCorrection.latitude + deltaU};
+        }
+
+        /**
+         * @brief 只保证视黄经精度的太阳坐标
+         * @details 黄经只依赖l, k, h与p, q，a仅经光行时影响黄经，由低阶项给出。
+         *          光行差项对近日点黄经的敏感度为K / e，k、h须与黄经同样按precision截断
+         * */
+        template<typename Policy>
+            requires validationPolicy<Policy>
+        GeoCoord<double, double, double> solarApparentLongitude(double tdb_jd_C, const vsop::CompiledData& data, double precision, double* rate = nullptr) {
+            const auto tolerance  = precision * std::numbers::pi / 648000;
+            const auto correction = std::max(precision, CORRECTION_PRECISION) * std::numbers::pi / 648000;
+
+            const std::array longitudeTolerance{correction, tolerance, tolerance, tolerance, tolerance / (2 * MAX_INCLINATION), tolerance / (2 * MAX_INCLINATION)};
+
+            return solarApparent(
+                tdb_jd_C,
+                [&](double t) { return vsop::vsop2013<Policy>(t, data, correction); },
+                [&](double t) { return vsop::vsop2013<Policy>(t, data, longitudeTolerance); },
+                [&](double t) { return vsop::calcCoefficents(t, data, longitudeTolerance); },
+                rate
+            );
+        }
+
+        /**
+         * @brief 只保证视黄经精度的月球坐标
+         * @details 只有V级数按所需精度求值，R只用于光行时，U只用于光行差，两者按CORRECTION_PRECISION截断
+         * */
+        GeoCoord<long double, long double, long double>
+        moonApparentLongitude(double tdb_jd_C, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, double precision, double solarAppLong) {
+            const auto correction        = std::max(precision, CORRECTION_PRECISION);
+            const auto distanceTolerance = correction * lea::MEAN_DISTANCE * std::numbers::pi / 648000;
+
+            return moonApparent(
+                tdb_jd_C,
+                [&](double t) { return lea::calcGeocentricDistance(t, rSeries, distanceTolerance); },
+                [&](double t) -> GeoCoord<long double, long double, long double> {
+                    return {lea::calcGeocentricDistance(t, rSeries, distanceTolerance), lea::calcTrueLongitude(t, vSeries, precision), lea::calcTrueLatitude(t, uSeries, correction)};
+                },
+                solarAppLong
+            );
+        }
+
+        ///< 编译数据的月球视坐标，solarLongitude(精度, 分量)给出光行差所需的太阳视黄经
+        template<typename SolarFunc>
+        GeoCoord<long double, long double, long double> moonApparentCompiled(
+            double tdb_jd_C,
+            const lea::CompiledSeries& rSeries,
+            const lea::CompiledSeries& vSeries,
+            const lea::CompiledSeries& uSeries,
+            double precision,
+            Component component,
+            const SolarFunc& solarLongitude
+        ) {
+            // 太阳视黄经只进入约20角秒的光行差项，低阶项即可
+            if (component == Component::Longitude)
+                return moonApparentLongitude(tdb_jd_C, rSeries, vSeries, uSeries, precision, solarLongitude(std::max(precision, CORRECTION_PRECISION), Component::Longitude));
+
+            const auto distanceTolerance = precision * lea::MEAN_DISTANCE * std::numbers::pi / 648000;
+
+            return moonApparent(
+                tdb_jd_C,
+                [&](double t) { return lea::calcGeocentricDistance(t, rSeries, distanceTolerance); },
+                [&](double t) { return lea::lea406(t, rSeries, vSeries, uSeries, precision); },
+                solarLongitude(precision, Component::All)
+            );
+        }
+    }  // namespace
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    GeoCoord<double, double, double> solarApparentCoordinate(double tdb_jd_C, const reader::Data& data) {
+        const auto trueCoord = [&](double t) { return vsop::vsop2013<Policy>(t, data); };
 
-            return travelTimeCorrection.longitude + delta - appLong;
-        };
+        return solarApparent(tdb_jd_C, trueCoord, trueCoord, [&](double t) { return vsop::calcCoefficents<double>(t, data); });
+    }
 
-        auto initLong          = travelTimeCorrection.longitude;
-        auto apparentLongitude = brent(aberrationFunc, initLong - 0.1, initLong + 0.1, 1e-8, 10);
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    GeoCoord<double, double, double> solarApparentCoordinate(double tdb_jd_C, const vsop::CompiledData& data, double precision, Component component) {
+        if (component == Component::Longitude) return solarApparentLongitude<Policy>(tdb_jd_C, data, precision);
 
-        auto apparentLatitude =
-            -K * std::sin(travelTimeCorrection.latitude * std::numbers::pi_v<double> / 180) * std::sin((apparentLongitude - perihelionLongitude) * std::numbers::pi_v<double> / 180) / 3600
-            + travelTimeCorrection.latitude;
+        // 角秒 -> 弧度，作为各根数级数的截断容差
+        const auto tolerance = precision * std::numbers::pi / 648000;
+        const auto trueCoord = [&](double t) { return vsop::vsop2013<Policy>(t, data, tolerance); };
 
-        return {travelTimeCorrection.geocentricDistance, apparentLongitude, apparentLatitude};
+        return solarApparent(tdb_jd_C, trueCoord, trueCoord, [&](double t) { return vsop::calcCoefficents(t, data, tolerance); });
     }
 
+    template GeoCoord<double, double, double> solarApparentCoordinate<validation::Checked>(double tdb_jd_C, const reader::Data& data);
+
+    template GeoCoord<double, double, double> solarApparentCoordinate<validation::Checked>(double tdb_jd_C, const vsop::CompiledData& data, double precision, Component component);
+
+    template GeoCoord<double, double, double> solarApparentCoordinate<validation::DebugOnly>(double tdb_jd_C, const reader::Data& data);
+
+    template GeoCoord<double, double, double> solarApparentCoordinate<validation::DebugOnly>(double tdb_jd_C, const vsop::CompiledData& data, double precision, Component component);
+
+    template GeoCoord<double, double, double> solarApparentCoordinate<validation::Unchecked>(double tdb_jd_C, const reader::Data& data);
+
+    template GeoCoord<double, double, double> solarApparentCoordinate<validation::Unchecked>(double tdb_jd_C, const vsop::CompiledData& data, double precision, Component component);
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
     GeoCoord<long double, long double, long double> moonApparentCoordinate(double tdb_jd_C, const reader::Data& data, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData) {
-        auto moonTrueCoords = lea::lea406(tdb_jd_C, rData, vData, uData);
+        return moonApparent(
+            tdb_jd_C,
+            [&](double t) { return lea::calcGeocentricDistance(t, rData); },
+            [&](double t) { return lea::lea406(t, rData, vData, uData); },
+            solarApparentCoordinate<Policy>(tdb_jd_C, data).longitude
+        );
+    }
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    GeoCoord<long double, long double, long double> moonApparentCoordinate(
+        double tdb_jd_C,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        double precision,
+        Component component
+    ) {
+        return moonApparentCompiled(tdb_jd_C, rSeries, vSeries, uSeries, precision, component, [&](double solarPrecision, Component solarComponent) {
+            return solarApparentCoordinate<Policy>(tdb_jd_C, data, solarPrecision, solarComponent).longitude;
+        });
+    }
+
+    template GeoCoord<long double, long double, long double>
+    moonApparentCoordinate<validation::Checked>(double tdb_jd_C, const reader::Data& data, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData);
+
+    template GeoCoord<long double, long double, long double> moonApparentCoordinate<validation::Checked>(
+        double tdb_jd_C, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, double precision, Component component
+    );
+
+    template GeoCoord<long double, long double, long double>
+    moonApparentCoordinate<validation::DebugOnly>(double tdb_jd_C, const reader::Data& data, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData);
+
+    template GeoCoord<long double, long double, long double> moonApparentCoordinate<validation::DebugOnly>(
+        double tdb_jd_C, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, double precision, Component component
+    );
+
+    template GeoCoord<long double, long double, long double>
+    moonApparentCoordinate<validation::Unchecked>(double tdb_jd_C, const reader::Data& data, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData);
+
+    template GeoCoord<long double, long double, long double> moonApparentCoordinate<validation::Unchecked>(
+        double tdb_jd_C, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, double precision, Component component
+    );
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    GeoCoord<double, double, double>
+    solarApparentCoordinate(const double tdb_jd_C, const vsop::CompiledData& data, SolarCoordinateCache& cache, const double precision, const Component component) {
+        return cache.get({tdb_jd_C, precision, static_cast<std::uint32_t>(component)}, [&] { return solarApparentCoordinate<Policy>(tdb_jd_C, data, precision, component); });
+    }
+
+    template GeoCoord<double, double, double>
+    solarApparentCoordinate<validation::Checked>(double tdb_jd_C, const vsop::CompiledData& data, SolarCoordinateCache& cache, double precision, Component component);
+
+    template GeoCoord<double, double, double>
+    solarApparentCoordinate<validation::DebugOnly>(double tdb_jd_C, const vsop::CompiledData& data, SolarCoordinateCache& cache, double precision, Component component);
+
+    template GeoCoord<double, double, double>
+    solarApparentCoordinate<validation::Unchecked>(double tdb_jd_C, const vsop::CompiledData& data, SolarCoordinateCache& cache, double precision, Component component);
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    GeoCoord<long double, long double, long double> moonApparentCoordinate(
+        const double tdb_jd_C,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        MoonCoordinateCache& cache,
+        SolarCoordinateCache& solarCache,
+        const double precision,
+        const Component component
+    ) {
+        // 光行差所需的太阳视黄经同样经缓存求值，与太阳视坐标的查询共用同一个缓存
+        return cache.get({tdb_jd_C, precision, static_cast<std::uint32_t>(component)}, [&] {
+            return moonApparentCompiled(tdb_jd_C, rSeries, vSeries, uSeries, precision, component, [&](double solarPrecision, Component solarComponent) {
+                return solarApparentCoordinate<Policy>(tdb_jd_C, data, solarCache, solarPrecision, solarComponent).longitude;
+            });
+        });
+    }
+
+    template GeoCoord<long double, long double, long double> moonApparentCoordinate<validation::Checked>(
+        double tdb_jd_C, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, MoonCoordinateCache& cache, SolarCoordinateCache& solarCache,
+        double precision, Component component
+    );
+
+    template GeoCoord<long double, long double, long double> moonApparentCoordinate<validation::DebugOnly>(
+        double tdb_jd_C, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, MoonCoordinateCache& cache, SolarCoordinateCache& solarCache,
+        double precision, Component component
+    );
+
+    template GeoCoord<long double, long double, long double> moonApparentCoordinate<validation::Unchecked>(
+        double tdb_jd_C, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, MoonCoordinateCache& cache, SolarCoordinateCache& solarCache,
+        double precision, Component component
+    );
+
+    double unwrapElongation(const double tdb_jd_C, const double elongation) {
+        // 真黄经差与平距角D之差不超过十余度，以D为参考取模即可得到连续的展开值
+        const auto mean = lea::meanAngleDistance(tdb_jd_C / 10);
+
+        return mean + std::remainder(elongation - mean, 360.0);
+    }
 
-        auto solarAppLong = solarApparentCoordinate(tdb_jd_C, data).longitude;
+    double predictElongation(const double tdb_jd_C, const double target) {
+        // 平距角的二次以上项很小，按线性项(角秒/千年，折为度/世纪)外推两次即可
+        const auto rate = lea::ARGUMENT_POLYNOMIALS[3][1] / 36000;
 
-        // 光行时修正
-        auto tau = moonTrueCoords.geocentricDistance / LIGHT_SPEED;
+        auto t = tdb_jd_C;
 
-        auto travelTimeCorrection = lea::lea406(tdb_jd_C - tau, rData, vData, uData);
+        for (int i = 0; i < 2; ++i) t += (target - lea::meanAngleDistance(t / 10)) / rate;
 
-        // 光行差修正
-        const auto k = 20.49552;
+        return t;
+    }
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    Elongation moonSunElongation(const double tdb_jd_C, const reader::Data& data, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData) {
+        double solarRate{};
+
+        const auto trueCoord = [&](double t) { return vsop::vsop2013<Policy>(t, data); };
+
+        const auto sun  = solarApparent(tdb_jd_C, trueCoord, trueCoord, [&](double t) { return vsop::calcCoefficents<double>(t, data); }, &solarRate);
+        const auto moon = moonApparent(tdb_jd_C, [&](double t) { return lea::calcGeocentricDistance(t, rData); }, [&](double t) { return lea::lea406(t, rData, vData, uData); }, sun.longitude);
+
+        // 未编译的级数无法逐项求导，月球取平黄经的速率
+        const auto moonRate = lea::meanLongitudeRate(tdb_jd_C / 10) / 10;
+
+        return {unwrapElongation(tdb_jd_C, static_cast<double>(moon.longitude) - sun.longitude), moonRate - solarRate};
+    }
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    Elongation moonSunElongation(
+        const double tdb_jd_C, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, const double precision
+    ) {
+        double solarRate{};
+
+        // 太阳每个历元只求一次，其视黄经同时用于月球的光行差修正；黄经差只需两者的黄经
+        const auto sun  = solarApparentLongitude<Policy>(tdb_jd_C, data, precision, &solarRate);
+        const auto moon = moonApparentLongitude(tdb_jd_C, rSeries, vSeries, uSeries, precision, sun.longitude);
+
+        const auto moonRate = lea::calcTrueLongitudeRate(tdb_jd_C, vSeries, std::max(precision, ELONGATION_RATE_PRECISION));
+
+        return {unwrapElongation(tdb_jd_C, static_cast<double>(moon.longitude) - sun.longitude), moonRate - solarRate};
+    }
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    void moonSunElongation(
+        const std::span<const double> tdb_jd_C,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        const std::span<Elongation> elongation,
+        const double precision
+    ) {
+        if (elongation.size() != tdb_jd_C.size()) throw std::invalid_argument(std::format("moonSunElongation: {} epochs but {} outputs", tdb_jd_C.size(), elongation.size()));
+
+        const auto lanes             = tdb_jd_C.size();
+        const auto correction        = std::max(precision, CORRECTION_PRECISION);
+        const auto distanceTolerance = correction * lea::MEAN_DISTANCE * std::numbers::pi / 648000;
+
+        // 太阳仍逐个历元求值，只有月球的三个级数按历元批量求值
+        std::vector<double> solarLongitude(lanes), solarRate(lanes);
+
+        for (std::size_t l{}; l < lanes; ++l) solarLongitude[l] = solarApparentLongitude<Policy>(tdb_jd_C[l], data, precision, &solarRate[l]).longitude;
+
+        // 光行时修正后的历元
+        std::vector<double> distance(lanes), retarded(lanes);
+
+        lea::calcSeries<lea::Trig::Cos>(tdb_jd_C, rSeries, distance, {}, distanceTolerance);
+
+        for (std::size_t l{}; l < lanes; ++l) retarded[l] = tdb_jd_C[l] - distance[l] * 1000 / LIGHT_SPEED / SECONDS_PER_CENTURY;
+
+        // 黄经速率与黄经共用各项正余弦，在光行时修正后的历元求出，与单历元版本的差异远小于速率本身的用途所需
+        std::vector<double> longitude(lanes), longitudeRate(lanes), latitude(lanes);
+
+        lea::calcSeries<lea::Trig::Sin>(retarded, vSeries, longitude, longitudeRate, precision);
+        lea::calcSeries<lea::Trig::Sin>(retarded, uSeries, latitude, {}, correction);
+
+        for (std::size_t l{}; l < lanes; ++l) {
+            const auto tm = retarded[l] / 10;
+
+            const auto moonLongitude = lea::meanLongitude(tm) + longitude[l] / 3600;
+            const auto moonLatitude  = latitude[l] / 3600;
+            const auto moonRate      = lea::meanLongitudeRate(tm) / 10 + longitudeRate[l] / 3600;
+
+            const auto [deltaV, deltaU] = moonAberration(moonLongitude, moonLatitude, solarLongitude[l]);
+
+            elongation[l] = {unwrapElongation(tdb_jd_C[l], moonLongitude + deltaV - solarLongitude[l]), moonRate - solarRate[l]};
+        }
+    }
+
+    template void moonSunElongation<validation::Checked>(
+        std::span<const double> tdb_jd_C, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, std::span<Elongation> elongation, double precision
+    );
+
+    template void moonSunElongation<validation::DebugOnly>(
+        std::span<const double> tdb_jd_C, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, std::span<Elongation> elongation, double precision
+    );
+
+    template void moonSunElongation<validation::Unchecked>(
+        std::span<const double> tdb_jd_C, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, std::span<Elongation> elongation, double precision
+    );
 
-        auto deltaV = k * std::cos(travelTimeCorrection.longitude - solarAppLong) / std::cos(travelTimeCorrection.latitude) / 3600;
-        auto deltaU = k * std::sin(travelTimeCorrection.latitude) * std::sin(travelTimeCorrection.longitude - solarAppLong) / 3600;
+    template Elongation moonSunElongation<validation::Checked>(double tdb_jd_C, const reader::Data& data, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData);
 
-        return {travelTimeCorrection.geocentricDistance, travelTimeCorrection.longitude + deltaV, travelTimeCorrection.latitude + deltaU};
+    template Elongation moonSunElongation<validation::Checked>(
+        double tdb_jd_C, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, double precision
+    );
+
+    template Elongation moonSunElongation<validation::DebugOnly>(double tdb_jd_C, const reader::Data& data, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData);
+
+    template Elongation moonSunElongation<validation::DebugOnly>(
+        double tdb_jd_C, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, double precision
+    );
+
+    template Elongation moonSunElongation<validation::Unchecked>(double tdb_jd_C, const reader::Data& data, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData);
+
+    template Elongation moonSunElongation<validation::Unchecked>(
+        double tdb_jd_C, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, double precision
+    );
+
+    double meanSolarLongitude(const double tdb_jd_C) { return vsop::lambdaEarthMoon(tdb_jd_C / 10) / DEGREE + 180; }
+
+    double unwrapSolarLongitude(const double tdb_jd_C, const double longitude) {
+        // 视黄经与平黄经之差不超过SOLAR_LONGITUDE_DEVIATION，以平黄经为参考取模即可得到连续的展开值
+        const auto mean = meanSolarLongitude(tdb_jd_C);
+
+        return mean + std::remainder(longitude - mean, 360.0);
+    }
+
+    double predictSolarLongitude(const double tdb_jd_C, const double target) {
+        const auto rate = vsop::LAMBDA_COEFFICIENTS[2][1] / DEGREE / 10;
+
+        // 地月系平黄经是线性的，外推一次即可
+        return tdb_jd_C + (target - meanSolarLongitude(tdb_jd_C)) / rate;
+    }
+
+    double termLongitude(const Term term) { return std::fmod(static_cast<int>(term) + 315, 360.0); }
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    SolarLongitude solarLongitude(const double tdb_jd_C, const vsop::CompiledData& data, const double precision) {
+        double rate{};
+
+        const auto sun = solarApparentLongitude<Policy>(tdb_jd_C, data, precision, &rate);
+
+        return {unwrapSolarLongitude(tdb_jd_C, sun.longitude), rate};
     }
 
+    template SolarLongitude solarLongitude<validation::Checked>(double tdb_jd_C, const vsop::CompiledData& data, double precision);
+
+    template SolarLongitude solarLongitude<validation::DebugOnly>(double tdb_jd_C, const vsop::CompiledData& data, double precision);
+
+    template SolarLongitude solarLongitude<validation::Unchecked>(double tdb_jd_C, const vsop::CompiledData& data, double precision);
+
     constexpr double MEAN_LUNAR_MONTH = 29.530588853;
 
+    constexpr double SECONDS_PER_CENTURY = 86400.0 * 36525;
+
+    constexpr double EVENT_TOLERANCE = 0.1;
+
+    constexpr double ELONGATION_DEVIATION = 15.0;
+
+    constexpr double SOLAR_LONGITUDE_DEVIATION = 2.5;
+
+    constexpr double SOLAR_ENVELOPE_FACTOR = 8.0;
+
+    constexpr int REFINEMENT_STEPS = 2;
+
+    double solarLongitudeEnvelope(const double precision) { return SOLAR_ENVELOPE_FACTOR * precision / 3600; }
+
+    double elongationEnvelope(const double precision) { return (SOLAR_ENVELOPE_FACTOR + 1) * precision / 3600; }
+
+    constexpr double ELONGATION_RATE_PRECISION = 1.0;
+
+    constexpr double CORRECTION_PRECISION = 36.0;
+
+    constexpr double LUNAR_PHASE_MARGIN = 1e-6;
+
 }  // namespace astro
@@ -18,25 +18,254 @@
 #pragma once
 
 #include "src/ast.h"
+#include "cache.h"
 #include "constant.h"
+#include "lea.h"
+#include "utils.h"
+#include "vsop.h"
 #include <functional>
+#include <limits>
+#include <span>
 
 namespace astro {
+    ///< 视坐标需要达到精度的分量
+    enum class Component {
+        ///< 距离、黄经、黄纬均按所需精度求值
+        All,
+        ///< 只保证黄经精度，距离与黄纬仅用于光行时与光行差修正，由低阶项给出
+        Longitude
+    };
+
+    ///< 仅用于光行时、光行差修正的级数的截断精度(角秒)，由此引入的黄经误差小于0.001角秒
+    extern const double CORRECTION_PRECISION;
+
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
     GeoCoord<double, double, double> solarApparentCoordinate(double tdb_jd_C, const reader::Data& data);
 
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    GeoCoord<double, double, double> solarApparentCoordinate(double tdb_jd_C, const vsop::CompiledData& data, double precision = 0, Component component = Component::All);
+
     using solarAppCoordResult = GeoCoord<double, double, double>;
 
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
     GeoCoord<long double, long double, long double> moonApparentCoordinate(double tdb_jd_C, const reader::Data& data, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData);
 
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    GeoCoord<long double, long double, long double> moonApparentCoordinate(
+        double tdb_jd_C,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        double precision    = 0,
+        Component component = Component::All
+    );
+
     using moonAppCoordResult = GeoCoord<long double, long double, long double>;
 
+    using SolarCoordinateCache = EpochCache<solarAppCoordResult>;
+
+    using MoonCoordinateCache = EpochCache<moonAppCoordResult>;
+
+    ///< 带缓存的视坐标，键为(历元, 精度, 分量)；缓存不区分数据，一个缓存只能配合同一组编译数据使用
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    GeoCoord<double, double, double>
+    solarApparentCoordinate(double tdb_jd_C, const vsop::CompiledData& data, SolarCoordinateCache& cache, double precision = 0, Component component = Component::All);
+
+    ///< 光行差所需的太阳视黄经经solarCache求值，可与上面的太阳视坐标查询共用同一个缓存
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    GeoCoord<long double, long double, long double> moonApparentCoordinate(
+        double tdb_jd_C,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        MoonCoordinateCache& cache,
+        SolarCoordinateCache& solarCache,
+        double precision    = 0,
+        Component component = Component::All
+    );
+
     extern const double MEAN_LUNAR_MONTH;
 
+    struct Elongation {
+        ///< 月日视黄经差(度)，以平距角为参考展开，跨越0/360时连续，第k次合朔处为360k
+        double value;
+        ///< 黄经差的变化率(度/儒略世纪)
+        double rate;
+    };
+
+    ///< 将月日黄经差展开为随时间连续的值
+    double unwrapElongation(double tdb_jd_C, double elongation);
+
+    ///< 求黄经差速率时月球级数的截断精度(角秒)，速率只用于预测，不影响根的精度
+    extern const double ELONGATION_RATE_PRECISION;
+
+    ///< 判断"下一次"月相时的余量(周)，避免起点恰为该月相时返回起点本身
+    extern const double LUNAR_PHASE_MARGIN;
+
+    /**
+     * @brief 月日视黄经差及其速率，太阳每个历元只求一次
+     * @note 未编译的级数无法逐项求导，此时月球速率取平黄经速率，误差约10%
+     * */
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    Elongation moonSunElongation(double tdb_jd_C, const reader::Data& data, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData);
+
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    Elongation moonSunElongation(
+        double tdb_jd_C, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, double precision = 0
+    );
+
+    /**
+     * @brief 多个历元上的月日视黄经差，月球三个级数按历元批量求值
+     * @throw std::invalid_argument 输出区间与历元数不一致
+     * */
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    void moonSunElongation(
+        std::span<const double> tdb_jd_C,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        std::span<Elongation> elongation,
+        double precision = 0
+    );
+
+    ///< 太阳视黄经截断误差相对截断精度的放大倍数: l至多放大1 + 2e倍，k、h各至多2倍，p、q的容差已按2i缩放各至多1倍
+    extern const double SOLAR_ENVELOPE_FACTOR;
+
+    ///< 两级求解中完整理论的最多求值次数，仍未收敛时退回区间求根
+    extern const int REFINEMENT_STEPS;
+
+    ///< 只保证黄经精度、按precision(角秒)截断时太阳视黄经的误差上界(度)
+    double solarLongitudeEnvelope(double precision);
+
+    ///< 按precision(角秒)截断时月日黄经差的误差上界(度)，月球只有V级数按precision截断
+    double elongationEnvelope(double precision);
+
     template<typename Func, typename A, typename R>
     concept coordinateCalcFunc = requires(Func f, A a) {
         { f(a) } -> std::same_as<R>;
     };
 
+    // 可指定精度(角秒)的坐标函数: f(t, precision)，precision为0时使用完整级数
+    template<typename Func, typename A, typename R>
+    concept precisionCoordinateCalcFunc = requires(Func f, A a) {
+        { f(a, 0.0) } -> std::same_as<R>;
+    };
+
+    template<typename Func>
+    concept elongationCalcFunc = requires(Func f, double t) {
+        { f(t) } -> std::same_as<Elongation>;
+    };
+
+    ///< 由独立的太阳、月球坐标函数组成黄经差函数，速率取平均朔望速率；返回的函数保存两个坐标函数的副本
+    template<typename SolarFunc, typename MoonFunc>
+        requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult> && coordinateCalcFunc<MoonFunc, double, moonAppCoordResult>
+    auto composeElongation(const SolarFunc& solarCoord, const MoonFunc& moonCoord);
+
+    ///< 一儒略世纪的秒数
+    extern const double SECONDS_PER_CENTURY;
+
+    ///< 月相、节气等事件时刻的求解容差(秒)
+    extern const double EVENT_TOLERANCE;
+
+    ///< 真黄经差与平距角之差的上界(度)，起点离目标月相超过该值时由平距角即可确定月相序号
+    extern const double ELONGATION_DEVIATION;
+
+    ///< 平距角从tdb_jd_C附近增长到target的时刻，不求理论值，作为求根的预测值
+    double predictElongation(double tdb_jd_C, double target);
+
+    /**
+     * @brief 展开后的黄经差达到target的时刻
+     * @details 由平均运动预测初值，再以黄经差速率做牛顿/Halley校正，通常3次求值内达到EVENT_TOLERANCE
+     * */
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findElongation(double tdb_jd_C, double target, const ElongationFunc& elongation);
+
+    /**
+     * @brief 两级求解: 以廉价的粗略模型coarse定位，完整理论fine只用于最后至多REFINEMENT_STEPS次修正
+     * @details envelope为coarse相对fine的误差上界(度)，修正未收敛时在由其换算的时间区间内退回区间求根
+     * */
+    template<typename CoarseFunc, typename FineFunc>
+        requires elongationCalcFunc<CoarseFunc> && elongationCalcFunc<FineFunc>
+    double findElongation(double tdb_jd_C, double target, const CoarseFunc& coarse, const FineFunc& fine, double envelope);
+
+    ///< tdb_jd_C之后黄经差第一次为phase(度，0朔、90上弦、180望、270下弦)的时刻
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findLunarPhaseForward(double tdb_jd_C, double phase, const ElongationFunc& elongation);
+
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findLunarPhaseBackward(double tdb_jd_C, double phase, const ElongationFunc& elongation);
+
+    template<typename CoarseFunc, typename FineFunc>
+        requires elongationCalcFunc<CoarseFunc> && elongationCalcFunc<FineFunc>
+    double findLunarPhaseForward(double tdb_jd_C, double phase, const CoarseFunc& coarse, const FineFunc& fine, double envelope);
+
+    template<typename CoarseFunc, typename FineFunc>
+        requires elongationCalcFunc<CoarseFunc> && elongationCalcFunc<FineFunc>
+    double findLunarPhaseBackward(double tdb_jd_C, double phase, const CoarseFunc& coarse, const FineFunc& fine, double envelope);
+
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findNewMoonMoment(double tdb_jd_C, const ElongationFunc& elongation);
+
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findNextNewMoon(double tdb_jd_C, const ElongationFunc& elongation);
+
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findPrevNewMoon(double tdb_jd_C, const ElongationFunc& elongation);
+
+    template<typename CoarseFunc, typename FineFunc>
+        requires elongationCalcFunc<CoarseFunc> && elongationCalcFunc<FineFunc>
+    double findNextNewMoon(double tdb_jd_C, const CoarseFunc& coarse, const FineFunc& fine, double envelope);
+
+    template<typename CoarseFunc, typename FineFunc>
+        requires elongationCalcFunc<CoarseFunc> && elongationCalcFunc<FineFunc>
+    double findPrevNewMoon(double tdb_jd_C, const CoarseFunc& coarse, const FineFunc& fine, double envelope);
+
+    template<typename Func>
+    concept batchElongationCalcFunc = batchRateFunc<Func, Elongation>;
+
+    /**
+     * @brief 批量求各黄经差达到target[i]的时刻，所有根同步推进，每轮对仍未收敛的根做一次批量求值
+     * @throw std::invalid_argument 区间长度不一致
+     * @note 各根的校正步与单历元求解相同，但批量求值与单历元求值有舍入误差量级的差别，根只在求解容差内一致，不保证逐位相同
+     * */
+    template<typename BatchFunc>
+        requires batchElongationCalcFunc<BatchFunc>
+    void findElongation(std::span<const double> tdb_jd_C, std::span<const double> target, const BatchFunc& elongation, std::span<double> roots);
+
+    template<typename BatchFunc>
+        requires batchElongationCalcFunc<BatchFunc>
+    void findLunarPhaseForward(std::span<const double> tdb_jd_C, double phase, const BatchFunc& elongation, std::span<double> roots);
+
+    template<typename BatchFunc>
+        requires batchElongationCalcFunc<BatchFunc>
+    void findLunarPhaseBackward(std::span<const double> tdb_jd_C, double phase, const BatchFunc& elongation, std::span<double> roots);
+
+    template<typename BatchFunc>
+        requires batchElongationCalcFunc<BatchFunc>
+    void findNextNewMoon(std::span<const double> tdb_jd_C, const BatchFunc& elongation, std::span<double> roots);
+
+    template<typename BatchFunc>
+        requires batchElongationCalcFunc<BatchFunc>
+    void findPrevNewMoon(std::span<const double> tdb_jd_C, const BatchFunc& elongation, std::span<double> roots);
+
     template<typename SolarFunc, typename MoonFunc>
         requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult> && coordinateCalcFunc<MoonFunc, double, moonAppCoordResult>
     double findNewMoonMoment(double tdb_jd_C, const SolarFunc& solarCoord, const MoonFunc& moonCoord);
@@ -49,18 +278,107 @@ namespace astro {
         requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult> && coordinateCalcFunc<MoonFunc, double, moonAppCoordResult>
     double findPrevNewMoon(double tdb_jd_C, const SolarFunc& solarCoord, const MoonFunc& moonCoord);
 
+    ///< 以coarsePrecision截断的级数为粗略模型两级求解，误差上界由elongationEnvelope给出，要求坐标函数按本库的截断方式实现
+    template<typename SolarFunc, typename MoonFunc>
+        requires precisionCoordinateCalcFunc<SolarFunc, double, solarAppCoordResult> && precisionCoordinateCalcFunc<MoonFunc, double, moonAppCoordResult>
+    double findNextNewMoon(double tdb_jd_C, const SolarFunc& solarCoord, const MoonFunc& moonCoord, double coarsePrecision);
+
+    template<typename SolarFunc, typename MoonFunc>
+        requires precisionCoordinateCalcFunc<SolarFunc, double, solarAppCoordResult> && precisionCoordinateCalcFunc<MoonFunc, double, moonAppCoordResult>
+    double findPrevNewMoon(double tdb_jd_C, const SolarFunc& solarCoord, const MoonFunc& moonCoord, double coarsePrecision);
+
+    ///< 离tdb_jd_C最近的一次交节；节气的黄经由termLongitude给出，坐标函数的视黄经经composeSolarLongitude展开后求解
+    template<typename SolarFunc>
+        requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult>
+    double findSolarTerm(double tdb_jd_C, Term term, const SolarFunc& solarCoord);
+
     template<typename SolarFunc>
         requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult>
-    double findSolarTerm(double tdb_jd_C, Term longitude, const SolarFunc& solarCoord);
+    double findSolarTermForward(double tdb_jd_C, Term term, const SolarFunc& solarCoord);
 
     template<typename SolarFunc>
         requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult>
-    double findSolarTermForward(double tdb_jd_C, Term longitude, const SolarFunc& solarCoord);
+    double findSolarTermBackward(double tdb_jd_C, Term term, const SolarFunc& solarCoord);
+
+    ///< 误差上界由solarLongitudeEnvelope给出
+    template<typename SolarFunc>
+        requires precisionCoordinateCalcFunc<SolarFunc, double, solarAppCoordResult>
+    double findSolarTermForward(double tdb_jd_C, Term term, const SolarFunc& solarCoord, double coarsePrecision);
+
+    template<typename SolarFunc>
+        requires precisionCoordinateCalcFunc<SolarFunc, double, solarAppCoordResult>
+    double findSolarTermBackward(double tdb_jd_C, Term term, const SolarFunc& solarCoord, double coarsePrecision);
 
+    struct SolarLongitude {
+        ///< 太阳视黄经(度)，以平黄经为参考展开，随时间连续
+        double value;
+        ///< 视黄经的变化率(度/儒略世纪)
+        double rate;
+    };
+
+    ///< 太阳视黄经与平黄经之差的上界(度)，含中心差与光行差
+    extern const double SOLAR_LONGITUDE_DEVIATION;
+
+    ///< 地心太阳平黄经(度)，即地月系日心平黄经加180度，未取模
+    double meanSolarLongitude(double tdb_jd_C);
+
+    ///< 将太阳视黄经展开为随时间连续的值
+    double unwrapSolarLongitude(double tdb_jd_C, double longitude);
+
+    ///< 平黄经从tdb_jd_C附近增长到target的时刻，作为求根的预测值
+    double predictSolarLongitude(double tdb_jd_C, double target);
+
+    ///< 节气对应的太阳视黄经(度)，Term的取值以立春为0，比视黄经大45度
+    double termLongitude(Term term);
+
+    ///< 只保证黄经精度的太阳视黄经及其速率
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    SolarLongitude solarLongitude(double tdb_jd_C, const vsop::CompiledData& data, double precision = 0);
+
+    template<typename Func>
+    concept solarLongitudeCalcFunc = requires(Func f, double t) {
+        { f(t) } -> std::same_as<SolarLongitude>;
+    };
+
+    ///< 由太阳坐标函数组成展开的视黄经函数，速率取平均运动；返回的函数保存坐标函数的副本
     template<typename SolarFunc>
         requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult>
-    double findSolarTermBackward(double tdb_jd_C, Term longitude, const SolarFunc& solarCoord);
+    auto composeSolarLongitude(const SolarFunc& solarCoord);
 
+    ///< 展开后的太阳视黄经达到target的时刻，与findElongation相同由平均运动预测后校正
+    template<typename SolarFunc>
+        requires solarLongitudeCalcFunc<SolarFunc>
+    double findSolarLongitude(double tdb_jd_C, double target, const SolarFunc& solarLong);
+
+    ///< tdb_jd_C之后太阳第一次到达节气term的时刻
+    template<typename SolarFunc>
+        requires solarLongitudeCalcFunc<SolarFunc>
+    double findSolarTermForward(double tdb_jd_C, Term term, const SolarFunc& solarLong);
+
+    template<typename SolarFunc>
+        requires solarLongitudeCalcFunc<SolarFunc>
+    double findSolarTermBackward(double tdb_jd_C, Term term, const SolarFunc& solarLong);
+
+    struct SolarTermEvent {
+        Term term;
+        ///< 交节时刻(儒略世纪，TDB)
+        double tdb_jd_C;
+    };
+
+    /**
+     * @brief tdb_jd_C之后、until之前的各次合朔，按时间顺序惰性求出
+     * @details 第k次合朔的展开黄经差恰为360k，每次以上一次合朔为起点、目标加360度，由平均朔望月预测初值，不再为确定序号求值
+     * @note elongation按值保存在序列中，序列可以比传入的临时函数对象活得久；其引用捕获的数据仍须在序列使用期间有效
+     * */
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    EventStream<double> newMoonStream(double tdb_jd_C, const ElongationFunc& elongation, double until = std::numeric_limits<double>::infinity());
+
+    ///< tdb_jd_C之后、until之前的各个节气，每次以上一节气为起点、目标加15度，solarLong按值保存在序列中
+    template<typename SolarFunc>
+        requires solarLongitudeCalcFunc<SolarFunc>
+    EventStream<SolarTermEvent> solarTermStream(double tdb_jd_C, const SolarFunc& solarLong, double until = std::numeric_limits<double>::infinity());
 }  // namespace astro
 
 #include "calender.hpp"
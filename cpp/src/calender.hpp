@@ -18,56 +18,386 @@
 #pragma once
 
 #include "utils.h"
+#include <cmath>
+#include <format>
+#include <numbers>
+#include <stdexcept>
+#include <vector>
 
 namespace astro {
     template<typename SolarFunc, typename MoonFunc>
         requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult> && coordinateCalcFunc<MoonFunc, double, moonAppCoordResult>
-    double findNewMoonMoment(double tdb_jd_C, const SolarFunc& solarCoord, const MoonFunc& moonCoord) {
-        auto newMoonEqu = [&](double t) { return moonCoord(t).longitude - solarCoord(t).longitude; };
+    auto composeElongation(const SolarFunc& solarCoord, const MoonFunc& moonCoord) {
+        return [solarCoord, moonCoord](double t) -> Elongation {
+            const auto elongation = static_cast<double>(moonCoord(t).longitude) - solarCoord(t).longitude;
+
+            return {unwrapElongation(t, elongation), 360 / MEAN_LUNAR_MONTH * 36525};
+        };
+    }
+
+    /**
+     * @brief 用于确定月相序号的黄经差
+     * @details 平距角与boundary(度)的距离超过ELONGATION_DEVIATION时，真黄经差与之位于boundary的同一侧，直接返回平距角
+     * */
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double elongationNear(double tdb_jd_C, double boundary, const ElongationFunc& elongation) {
+        const auto mean = lea::meanAngleDistance(tdb_jd_C / 10);
+
+        return std::abs(std::remainder(mean - boundary, 360.0)) > ELONGATION_DEVIATION ? mean : elongation(tdb_jd_C).value;
+    }
+
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findElongation(double tdb_jd_C, double target, const ElongationFunc& elongation) {
+        return solveMonotonic(elongation, target, predictElongation(tdb_jd_C, target), EVENT_TOLERANCE / SECONDS_PER_CENTURY);
+    }
+
+    template<typename CoarseFunc, typename FineFunc>
+        requires elongationCalcFunc<CoarseFunc> && elongationCalcFunc<FineFunc>
+    double findElongation(double tdb_jd_C, double target, const CoarseFunc& coarse, const FineFunc& fine, double envelope) {
+        const auto root = findElongation(tdb_jd_C, target, coarse);
+        const auto rate = coarse(root).rate;
+
+        auto elongationEqu = [&](double t) { return fine(t).value - target; };
+
+        // 粗略根与真根之差不超过envelope / rate，取两倍作为退回时的搜索半径
+        return refineRoot(elongationEqu, root, rate, 2 * envelope / rate, EVENT_TOLERANCE / SECONDS_PER_CENTURY, REFINEMENT_STEPS);
+    }
+
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findLunarPhaseForward(double tdb_jd_C, double phase, const ElongationFunc& elongation) {
+        // 展开后的黄经差单调递增，取起点之后第一个phase + 360k；起点离目标月相较远时平距角即可确定k，省去一次求值
+        const auto cycles = std::floor((elongationNear(tdb_jd_C, phase, elongation) - phase) / 360 + LUNAR_PHASE_MARGIN) + 1;
+
+        return findElongation(tdb_jd_C, phase + 360 * cycles, elongation);
+    }
+
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findLunarPhaseBackward(double tdb_jd_C, double phase, const ElongationFunc& elongation) {
+        const auto cycles = std::ceil((elongationNear(tdb_jd_C, phase, elongation) - phase) / 360 - LUNAR_PHASE_MARGIN) - 1;
 
-        return brent(newMoonEqu, tdb_jd_C - 10, tdb_jd_C + 10, 1e-8, 10);
+        return findElongation(tdb_jd_C, phase + 360 * cycles, elongation);
+    }
+
+    /**
+     * @brief 两级求解时用于确定月相序号的黄经差
+     * @details 粗略黄经差离boundary不足envelope时，起点在月相时刻的哪一侧只能由完整理论判断，例如起点本身就是完整理论下的合朔
+     * */
+    template<typename CoarseFunc, typename FineFunc>
+        requires elongationCalcFunc<CoarseFunc> && elongationCalcFunc<FineFunc>
+    double elongationNear(double tdb_jd_C, double boundary, const CoarseFunc& coarse, const FineFunc& fine, double envelope) {
+        const auto elongation = elongationNear(tdb_jd_C, boundary, coarse);
+
+        return std::abs(std::remainder(elongation - boundary, 360.0)) > envelope ? elongation : fine(tdb_jd_C).value;
+    }
+
+    template<typename CoarseFunc, typename FineFunc>
+        requires elongationCalcFunc<CoarseFunc> && elongationCalcFunc<FineFunc>
+    double findLunarPhaseForward(double tdb_jd_C, double phase, const CoarseFunc& coarse, const FineFunc& fine, double envelope) {
+        const auto cycles = std::floor((elongationNear(tdb_jd_C, phase, coarse, fine, envelope) - phase) / 360 + LUNAR_PHASE_MARGIN) + 1;
+        const auto root   = findElongation(tdb_jd_C, phase + 360 * cycles, coarse, fine, envelope);
+
+        // 修正后的根不在起点之后时说明序号仍偏小，改求下一周期
+        return root - tdb_jd_C > LUNAR_PHASE_MARGIN * MEAN_LUNAR_MONTH / 36525 ? root : findElongation(tdb_jd_C, phase + 360 * (cycles + 1), coarse, fine, envelope);
+    }
+
+    template<typename CoarseFunc, typename FineFunc>
+        requires elongationCalcFunc<CoarseFunc> && elongationCalcFunc<FineFunc>
+    double findLunarPhaseBackward(double tdb_jd_C, double phase, const CoarseFunc& coarse, const FineFunc& fine, double envelope) {
+        const auto cycles = std::ceil((elongationNear(tdb_jd_C, phase, coarse, fine, envelope) - phase) / 360 - LUNAR_PHASE_MARGIN) - 1;
+        const auto root   = findElongation(tdb_jd_C, phase + 360 * cycles, coarse, fine, envelope);
+
+        return tdb_jd_C - root > LUNAR_PHASE_MARGIN * MEAN_LUNAR_MONTH / 36525 ? root : findElongation(tdb_jd_C, phase + 360 * (cycles - 1), coarse, fine, envelope);
+    }
+
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findNewMoonMoment(double tdb_jd_C, const ElongationFunc& elongation) {
+        // 最近的一次合朔，与前后两次合朔等距的分界在望附近
+        return findElongation(tdb_jd_C, 360 * std::round(elongationNear(tdb_jd_C, 180.0, elongation) / 360), elongation);
+    }
+
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findNextNewMoon(double tdb_jd_C, const ElongationFunc& elongation) {
+        return findLunarPhaseForward(tdb_jd_C, 0.0, elongation);
+    }
+
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findPrevNewMoon(double tdb_jd_C, const ElongationFunc& elongation) {
+        return findLunarPhaseBackward(tdb_jd_C, 0.0, elongation);
+    }
+
+    template<typename CoarseFunc, typename FineFunc>
+        requires elongationCalcFunc<CoarseFunc> && elongationCalcFunc<FineFunc>
+    double findNextNewMoon(double tdb_jd_C, const CoarseFunc& coarse, const FineFunc& fine, double envelope) {
+        return findLunarPhaseForward(tdb_jd_C, 0.0, coarse, fine, envelope);
+    }
+
+    template<typename CoarseFunc, typename FineFunc>
+        requires elongationCalcFunc<CoarseFunc> && elongationCalcFunc<FineFunc>
+    double findPrevNewMoon(double tdb_jd_C, const CoarseFunc& coarse, const FineFunc& fine, double envelope) {
+        return findLunarPhaseBackward(tdb_jd_C, 0.0, coarse, fine, envelope);
+    }
+
+    ///< elongationNear的批量版本，只对离boundary不足ELONGATION_DEVIATION的历元做一次批量求值
+    template<typename BatchFunc>
+        requires batchElongationCalcFunc<BatchFunc>
+    std::vector<double> elongationNear(std::span<const double> tdb_jd_C, double boundary, const BatchFunc& elongation) {
+        std::vector<double> result(tdb_jd_C.size());
+
+        std::vector<std::size_t> ambiguous;
+        std::vector<double> epochs;
+
+        for (std::size_t l{}; l < tdb_jd_C.size(); ++l) {
+            result[l] = lea::meanAngleDistance(tdb_jd_C[l] / 10);
+
+            if (std::abs(std::remainder(result[l] - boundary, 360.0)) <= ELONGATION_DEVIATION) {
+                ambiguous.push_back(l);
+                epochs.push_back(tdb_jd_C[l]);
+            }
+        }
+
+        if (ambiguous.empty()) return result;
+
+        std::vector<Elongation> samples(epochs.size());
+
+        elongation(std::span<const double>(epochs), std::span<Elongation>(samples));
+
+        for (std::size_t k{}; k < ambiguous.size(); ++k) result[ambiguous[k]] = samples[k].value;
+
+        return result;
+    }
+
+    template<typename BatchFunc>
+        requires batchElongationCalcFunc<BatchFunc>
+    void findElongation(std::span<const double> tdb_jd_C, std::span<const double> target, const BatchFunc& elongation, std::span<double> roots) {
+        if (target.size() != tdb_jd_C.size()) throw std::invalid_argument(std::format("findElongation: {} epochs but {} targets", tdb_jd_C.size(), target.size()));
+
+        std::vector<double> guess(tdb_jd_C.size());
+
+        for (std::size_t l{}; l < tdb_jd_C.size(); ++l) guess[l] = predictElongation(tdb_jd_C[l], target[l]);
+
+        solveMonotonic<Elongation>(elongation, target, guess, roots, EVENT_TOLERANCE / SECONDS_PER_CENTURY);
+    }
+
+    template<typename BatchFunc>
+        requires batchElongationCalcFunc<BatchFunc>
+    void findLunarPhaseForward(std::span<const double> tdb_jd_C, double phase, const BatchFunc& elongation, std::span<double> roots) {
+        const auto near = elongationNear(tdb_jd_C, phase, elongation);
+
+        std::vector<double> target(tdb_jd_C.size());
+
+        for (std::size_t l{}; l < tdb_jd_C.size(); ++l) target[l] = phase + 360 * (std::floor((near[l] - phase) / 360 + LUNAR_PHASE_MARGIN) + 1);
+
+        findElongation(tdb_jd_C, target, elongation, roots);
+    }
+
+    template<typename BatchFunc>
+        requires batchElongationCalcFunc<BatchFunc>
+    void findLunarPhaseBackward(std::span<const double> tdb_jd_C, double phase, const BatchFunc& elongation, std::span<double> roots) {
+        const auto near = elongationNear(tdb_jd_C, phase, elongation);
+
+        std::vector<double> target(tdb_jd_C.size());
+
+        for (std::size_t l{}; l < tdb_jd_C.size(); ++l) target[l] = phase + 360 * (std::ceil((near[l] - phase) / 360 - LUNAR_PHASE_MARGIN) - 1);
+
+        findElongation(tdb_jd_C, target, elongation, roots);
+    }
+
+    template<typename BatchFunc>
+        requires batchElongationCalcFunc<BatchFunc>
+    void findNextNewMoon(std::span<const double> tdb_jd_C, const BatchFunc& elongation, std::span<double> roots) {
+        findLunarPhaseForward(tdb_jd_C, 0.0, elongation, roots);
+    }
+
+    template<typename BatchFunc>
+        requires batchElongationCalcFunc<BatchFunc>
+    void findPrevNewMoon(std::span<const double> tdb_jd_C, const BatchFunc& elongation, std::span<double> roots) {
+        findLunarPhaseBackward(tdb_jd_C, 0.0, elongation, roots);
     }
 
     template<typename SolarFunc, typename MoonFunc>
         requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult> && coordinateCalcFunc<MoonFunc, double, moonAppCoordResult>
-    double findNextNewMoon(double tdb_jd_C, const SolarFunc& solarCoord, const MoonFunc& moonCoord) {
-        auto newMoonEqu = [&](double t) { return moonCoord(t).longitude - solarCoord(t).longitude; };
+    double findNewMoonMoment(double tdb_jd_C, const SolarFunc& solarCoord, const MoonFunc& moonCoord) {
+        return findNewMoonMoment(tdb_jd_C, composeElongation(solarCoord, moonCoord));
+    }
 
-        return findRootForward(newMoonEqu, tdb_jd_C, MEAN_LUNAR_MONTH, 1e-8);
+    template<typename SolarFunc, typename MoonFunc>
+        requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult> && coordinateCalcFunc<MoonFunc, double, moonAppCoordResult>
+    double findNextNewMoon(double tdb_jd_C, const SolarFunc& solarCoord, const MoonFunc& moonCoord) {
+        return findNextNewMoon(tdb_jd_C, composeElongation(solarCoord, moonCoord));
     }
 
     template<typename SolarFunc, typename MoonFunc>
         requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult> && coordinateCalcFunc<MoonFunc, double, moonAppCoordResult>
     double findPrevNewMoon(double tdb_jd_C, const SolarFunc& solarCoord, const MoonFunc& moonCoord) {
-        auto newMoonEqu = [&](double t) { return moonCoord(t).longitude - solarCoord(t).longitude; };
+        return findPrevNewMoon(tdb_jd_C, composeElongation(solarCoord, moonCoord));
+    }
 
-        return findRootBackward(newMoonEqu, tdb_jd_C, MEAN_LUNAR_MONTH, 1e-8);
+    // 先以粗精度级数定位，完整级数只用于最后的修正
+    template<typename SolarFunc, typename MoonFunc>
+        requires precisionCoordinateCalcFunc<SolarFunc, double, solarAppCoordResult> && precisionCoordinateCalcFunc<MoonFunc, double, moonAppCoordResult>
+    double findNextNewMoon(double tdb_jd_C, const SolarFunc& solarCoord, const MoonFunc& moonCoord, double coarsePrecision) {
+        auto coarseSolar = [&](double t) { return solarCoord(t, coarsePrecision); };
+        auto coarseMoon  = [&](double t) { return moonCoord(t, coarsePrecision); };
+        auto fineSolar   = [&](double t) { return solarCoord(t, 0.0); };
+        auto fineMoon    = [&](double t) { return moonCoord(t, 0.0); };
+
+        return findNextNewMoon(tdb_jd_C, composeElongation(coarseSolar, coarseMoon), composeElongation(fineSolar, fineMoon), elongationEnvelope(coarsePrecision));
+    }
+
+    template<typename SolarFunc, typename MoonFunc>
+        requires precisionCoordinateCalcFunc<SolarFunc, double, solarAppCoordResult> && precisionCoordinateCalcFunc<MoonFunc, double, moonAppCoordResult>
+    double findPrevNewMoon(double tdb_jd_C, const SolarFunc& solarCoord, const MoonFunc& moonCoord, double coarsePrecision) {
+        auto coarseSolar = [&](double t) { return solarCoord(t, coarsePrecision); };
+        auto coarseMoon  = [&](double t) { return moonCoord(t, coarsePrecision); };
+        auto fineSolar   = [&](double t) { return solarCoord(t, 0.0); };
+        auto fineMoon    = [&](double t) { return moonCoord(t, 0.0); };
+
+        return findPrevNewMoon(tdb_jd_C, composeElongation(coarseSolar, coarseMoon), composeElongation(fineSolar, fineMoon), elongationEnvelope(coarsePrecision));
     }
 
+    ///< 起点附近的太阳视黄经，离boundary较远时以平黄经代替，省去一次求值
     template<typename SolarFunc>
-        requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult>
-    double findSolarTerm(double tdb_jd_C, Term longitude, const SolarFunc& solarCoord) {
-        auto termEqu = [&](double t) { return solarCoord(t).longitude - static_cast<int>(longitude); };
+        requires solarLongitudeCalcFunc<SolarFunc>
+    double solarLongitudeNear(double tdb_jd_C, double boundary, const SolarFunc& solarLong) {
+        const auto mean = meanSolarLongitude(tdb_jd_C);
 
-        return brent(termEqu, tdb_jd_C - 30, tdb_jd_C + 30, 1e-6, 100);
+        return std::abs(std::remainder(mean - boundary, 360.0)) > SOLAR_LONGITUDE_DEVIATION ? mean : solarLong(tdb_jd_C).value;
+    }
+
+    template<typename SolarFunc>
+        requires solarLongitudeCalcFunc<SolarFunc>
+    double findSolarLongitude(double tdb_jd_C, double target, const SolarFunc& solarLong) {
+        return solveMonotonic(solarLong, target, predictSolarLongitude(tdb_jd_C, target), EVENT_TOLERANCE / SECONDS_PER_CENTURY);
+    }
+
+    template<typename SolarFunc>
+        requires solarLongitudeCalcFunc<SolarFunc>
+    double findSolarTermForward(double tdb_jd_C, Term term, const SolarFunc& solarLong) {
+        const auto longitude = termLongitude(term);
+        const auto cycles    = std::floor((solarLongitudeNear(tdb_jd_C, longitude, solarLong) - longitude) / 360 + LUNAR_PHASE_MARGIN) + 1;
+
+        return findSolarLongitude(tdb_jd_C, longitude + 360 * cycles, solarLong);
+    }
+
+    template<typename SolarFunc>
+        requires solarLongitudeCalcFunc<SolarFunc>
+    double findSolarTermBackward(double tdb_jd_C, Term term, const SolarFunc& solarLong) {
+        const auto longitude = termLongitude(term);
+        const auto cycles    = std::ceil((solarLongitudeNear(tdb_jd_C, longitude, solarLong) - longitude) / 360 - LUNAR_PHASE_MARGIN) - 1;
+
+        return findSolarLongitude(tdb_jd_C, longitude + 360 * cycles, solarLong);
     }
 
     template<typename SolarFunc>
         requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult>
-    double findSolarTermForward(double tdb_jd_C, Term longitude, const SolarFunc& solarCoord) {
-        auto termEqu = [&](double t) { return solarCoord(t).longitude - static_cast<int>(longitude); };
+    auto composeSolarLongitude(const SolarFunc& solarCoord) {
+        return [solarCoord](double t) -> SolarLongitude {
+            return {unwrapSolarLongitude(t, solarCoord(t).longitude), vsop::LAMBDA_COEFFICIENTS[2][1] * 180 / std::numbers::pi / 10};
+        };
+    }
+
+    template<typename SolarFunc>
+        requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult>
+    double findSolarTerm(double tdb_jd_C, Term term, const SolarFunc& solarCoord) {
+        const auto solarLong = composeSolarLongitude(solarCoord);
+        const auto longitude = termLongitude(term);
+        const auto cycles    = std::round((solarLongitudeNear(tdb_jd_C, longitude, solarLong) - longitude) / 360);
+
+        return findSolarLongitude(tdb_jd_C, longitude + 360 * cycles, solarLong);
+    }
 
-        return findRootForward(termEqu, tdb_jd_C, MEAN_LUNAR_MONTH / 2, 1e-6);
+    template<typename SolarFunc>
+        requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult>
+    double findSolarTermForward(double tdb_jd_C, Term term, const SolarFunc& solarCoord) {
+        return findSolarTermForward(tdb_jd_C, term, composeSolarLongitude(solarCoord));
     }
 
     template<typename SolarFunc>
         requires coordinateCalcFunc<SolarFunc, double, solarAppCoordResult>
-    double findSolarTermBackward(double tdb_jd_C, Term longitude, const SolarFunc& solarCoord) {
-        auto termEqu = [&](double t) { return solarCoord(t).longitude - static_cast<int>(longitude); };
+    double findSolarTermBackward(double tdb_jd_C, Term term, const SolarFunc& solarCoord) {
+        return findSolarTermBackward(tdb_jd_C, term, composeSolarLongitude(solarCoord));
+    }
+
+    ///< 以粗略模型求得的交节时刻root为初值，用完整级数修正
+    template<typename SolarFunc>
+        requires precisionCoordinateCalcFunc<SolarFunc, double, solarAppCoordResult>
+    double refineSolarTerm(double root, Term term, const SolarFunc& solarCoord, double coarsePrecision) {
+        const auto coarse = [&](double t) { return unwrapSolarLongitude(t, solarCoord(t, coarsePrecision).longitude); };
+
+        const auto longitude = termLongitude(term);
+        const auto target    = longitude + 360 * std::round((coarse(root) - longitude) / 360);
+
+        auto fineEqu = [&](double t) { return unwrapSolarLongitude(t, solarCoord(t, 0.0).longitude) - target; };
 
-        return findRootBackward(termEqu, tdb_jd_C, MEAN_LUNAR_MONTH / 2, 1e-6);
+        // 粗略模型的斜率由中心差分给出，只需两次廉价求值
+        const auto step  = 1 / 36525.0;
+        const auto slope = (coarse(root + step) - coarse(root - step)) / (2 * step);
+
+        return refineRoot(fineEqu, root, slope, 2 * solarLongitudeEnvelope(coarsePrecision) / slope, EVENT_TOLERANCE / SECONDS_PER_CENTURY, REFINEMENT_STEPS);
+    }
+
+    template<typename SolarFunc>
+        requires precisionCoordinateCalcFunc<SolarFunc, double, solarAppCoordResult>
+    double findSolarTermForward(double tdb_jd_C, Term term, const SolarFunc& solarCoord, double coarsePrecision) {
+        const auto coarseCoord = [&](double t) { return solarCoord(t, coarsePrecision); };
+
+        return refineSolarTerm(findSolarTermForward(tdb_jd_C, term, coarseCoord), term, solarCoord, coarsePrecision);
     }
 
+    template<typename SolarFunc>
+        requires precisionCoordinateCalcFunc<SolarFunc, double, solarAppCoordResult>
+    double findSolarTermBackward(double tdb_jd_C, Term term, const SolarFunc& solarCoord, double coarsePrecision) {
+        const auto coarseCoord = [&](double t) { return solarCoord(t, coarsePrecision); };
+
+        return refineSolarTerm(findSolarTermBackward(tdb_jd_C, term, coarseCoord), term, solarCoord, coarsePrecision);
+    }
+
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    EventStream<double> newMoonStream(double tdb_jd_C, const ElongationFunc& elongation, double until) {
+        auto target = 360 * (std::floor(elongationNear(tdb_jd_C, 0.0, elongation) / 360 + LUNAR_PHASE_MARGIN) + 1);
+
+        return EventStream<double>([elongation, tdb_jd_C, target, until]() mutable -> std::optional<double> {
+            const auto moment = findElongation(tdb_jd_C, target, elongation);
+
+            if (moment >= until) return std::nullopt;
+
+            tdb_jd_C = moment;
+            target += 360;
+
+            return moment;
+        });
+    }
+
+    template<typename SolarFunc>
+        requires solarLongitudeCalcFunc<SolarFunc>
+    EventStream<SolarTermEvent> solarTermStream(double tdb_jd_C, const SolarFunc& solarLong, double until) {
+        // 节气相隔15度，立春为第0个，视黄经315度
+        const auto origin   = termLongitude(Term::StartOfSprint);
+        const auto boundary = origin + 15 * std::round((meanSolarLongitude(tdb_jd_C) - origin) / 15);
+
+        auto index = static_cast<long long>(std::floor((solarLongitudeNear(tdb_jd_C, boundary, solarLong) - origin) / 15 + LUNAR_PHASE_MARGIN)) + 1;
+
+        return EventStream<SolarTermEvent>([solarLong, tdb_jd_C, origin, index, until]() mutable -> std::optional<SolarTermEvent> {
+            const auto moment = findSolarLongitude(tdb_jd_C, origin + 15.0 * static_cast<double>(index), solarLong);
+
+            if (moment >= until) return std::nullopt;
+
+            const SolarTermEvent event{TERM_TABLE[((index % 24) + 24) % 24], moment};
+
+            tdb_jd_C = moment;
+            ++index;
+
+            return event;
+        });
+    }
 }  // namespace astro
 
 #endif  // CALENDER_HPP
@@ -0,0 +1,247 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file catalog.cpp
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/09/09 19:42
+ * @brief
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#include "catalog.h"
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#if _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace astro {
+    constexpr std::array<char, 8> CATALOG_MAGIC = {'A', 'S', 'T', 'R', 'O', 'E', 'V', 'T'};
+
+    constexpr std::uint32_t CATALOG_VERSION = 1;
+
+    namespace {
+        // FNV-1a
+        constexpr std::uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+        constexpr std::uint64_t FNV_PRIME  = 0x100000001b3ULL;
+
+        std::uint64_t hashBytes(std::uint64_t hash, std::span<const std::byte> bytes) {
+            for (const auto byte : bytes) {
+                hash ^= static_cast<std::uint64_t>(byte);
+                hash *= FNV_PRIME;
+            }
+
+            return hash;
+        }
+
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        std::uint64_t feed(std::uint64_t hash, const T& value) { return hashBytes(hash, std::as_bytes(std::span(&value, 1))); }
+
+        ///< 长度也计入哈希，避免相邻数组的边界移动后哈希不变
+        template<typename T>
+        std::uint64_t feed(std::uint64_t hash, const std::vector<T>& values) { return hashBytes(feed(hash, values.size()), std::as_bytes(std::span(values))); }
+
+        std::uint64_t feed(std::uint64_t hash, const lea::CompiledSeries& series) {
+            hash = feed(hash, series.multipliers);
+            hash = feed(hash, series.cosCoefficients);
+
+            return feed(hash, series.sinCoefficients);
+        }
+
+        ///< 按(种类, 序号)排序
+        constexpr auto byKey = [](const CatalogRecord& lhs, const CatalogRecord& rhs) { return std::pair(lhs.kind, lhs.ordinal) < std::pair(rhs.kind, rhs.ordinal); };
+
+        CatalogHeader emptyHeader(std::uint64_t tag) { return {CATALOG_MAGIC, CATALOG_VERSION, sizeof(CatalogRecord), tag, 0}; }
+    }  // namespace
+
+    std::uint64_t catalogTag(const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, double precision) {
+        auto hash = feed(FNV_OFFSET, data.tables.size());
+
+        for (const auto& table : data.tables) {
+            hash = feed(hash, table.variable);
+            hash = feed(hash, table.power);
+            hash = feed(hash, table.multipliers);
+            hash = feed(hash, table.sinAmplitude);
+            hash = feed(hash, table.cosAmplitude);
+        }
+
+        for (const auto& polynomial : data.polynomial) hash = feed(hash, polynomial);
+
+        hash = feed(hash, data.polynomialCenter);
+        hash = feed(hash, data.validFrom);
+        hash = feed(hash, data.validTo);
+
+        for (const auto* series : {&rSeries, &vSeries, &uSeries}) hash = feed(hash, *series);
+
+        return feed(hash, precision);
+    }
+
+    EventCatalog::EventCatalog(const std::filesystem::path& path, std::uint64_t tag) : path(path), label(tag) {
+        merge();
+        map();
+
+        journal.open(path, std::ios::binary | std::ios::app);
+
+        if (!journal) throw std::runtime_error(std::format("EventCatalog: cannot open {} for writing", path.string()));
+    }
+
+    EventCatalog::~EventCatalog() { unmap(); }
+
+    void EventCatalog::merge() {
+        CatalogHeader header{};
+        std::vector<CatalogRecord> records;
+
+        if (std::ifstream file{path, std::ios::binary}) {
+            const auto size = std::filesystem::file_size(path);
+
+            if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != CATALOG_MAGIC)
+                throw std::runtime_error(std::format("EventCatalog: {} is not an event catalog", path.string()));
+
+            if (header.version != CATALOG_VERSION || header.recordSize != sizeof(CatalogRecord))
+                throw std::runtime_error(std::format("EventCatalog: {} has version {} with {}-byte records, expected version {} with {}-byte records", path.string(), header.version, header.recordSize, CATALOG_VERSION, sizeof(CatalogRecord)));
+
+            // 标签不同说明目录由别的数据或精度求得，不能混用，也不应覆盖
+            if (header.tag != label) throw std::invalid_argument(std::format("EventCatalog: {} has tag {:#018x}, expected {:#018x}", path.string(), header.tag, label));
+
+            // 末尾不完整的记录是写入中断留下的，丢弃
+            records.resize((size - sizeof(header)) / sizeof(CatalogRecord));
+
+            file.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(CatalogRecord)));
+
+            if (header.sorted == records.size() && size == sizeof(header) + records.size() * sizeof(CatalogRecord)) return;
+        }
+        else header = emptyHeader(label);
+
+        // 有序区之后的记录并入有序区，同一事件保留先写入的一条
+        std::stable_sort(records.begin(), records.end(), byKey);
+        records.erase(std::unique(records.begin(), records.end(), [](const auto& lhs, const auto& rhs) { return !byKey(lhs, rhs) && !byKey(rhs, lhs); }), records.end());
+
+        header.sorted = records.size();
+
+        // 先写临时文件再替换，重写中断时原目录不受影响
+        auto temporary = path;
+        temporary += ".tmp";
+
+        {
+            std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(CatalogRecord)));
+
+            if (!file.flush()) throw std::runtime_error(std::format("EventCatalog: cannot write {}", temporary.string()));
+        }
+
+        // Windows上被映射或打开的文件不能被替换，替换失败说明同一目录已在别处打开
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+
+        if (error) {
+            std::filesystem::remove(temporary, error);
+
+            throw std::runtime_error(std::format("EventCatalog: cannot replace {}, it may be open in another EventCatalog", path.string()));
+        }
+    }
+
+    void EventCatalog::map() {
+        const auto size = static_cast<std::size_t>(std::filesystem::file_size(path));
+
+#if _WIN32
+        const auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE) throw std::runtime_error(std::format("EventCatalog: cannot open {}", path.string()));
+
+        const auto handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+
+        if (!handle) throw std::runtime_error(std::format("EventCatalog: cannot map {}", path.string()));
+
+        mapping = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, size);
+        CloseHandle(handle);
+
+        if (!mapping) throw std::runtime_error(std::format("EventCatalog: cannot map {}", path.string()));
+
+#else
+        const auto file = ::open(path.c_str(), O_RDONLY);
+
+        if (file < 0) throw std::runtime_error(std::format("EventCatalog: cannot open {}", path.string()));
+
+        const auto address = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+        ::close(file);
+
+        if (address == MAP_FAILED) throw std::runtime_error(std::format("EventCatalog: cannot map {}", path.string()));
+
+        mapping = address;
+
+#endif
+
+        mappingSize = size;
+
+        const auto* header = static_cast<const CatalogHeader*>(mapping);
+        sorted             = {reinterpret_cast<const CatalogRecord*>(header + 1), static_cast<std::size_t>(header->sorted)};
+    }
+
+    void EventCatalog::unmap() noexcept {
+        if (!mapping) return;
+
+#if _WIN32
+        UnmapViewOfFile(mapping);
+#else
+        ::munmap(const_cast<void*>(mapping), mappingSize);
+#endif
+
+        mapping     = nullptr;
+        mappingSize = 0;
+        sorted      = {};
+    }
+
+    std::optional<double> EventCatalog::find(EventKind kind, std::int64_t ordinal) const {
+        const CatalogRecord key{ordinal, kind, 0, 0};
+
+        if (const auto it = std::lower_bound(sorted.begin(), sorted.end(), key, byKey); it != sorted.end() && !byKey(key, *it)) return it->tdb_jd_C;
+
+        std::lock_guard lock(mutex);
+
+        if (const auto it = appended.find({kind, ordinal}); it != appended.end()) return it->second;
+
+        return std::nullopt;
+    }
+
+    void EventCatalog::insert(EventKind kind, std::int64_t ordinal, double tdb_jd_C) {
+        const CatalogRecord record{ordinal, kind, 0, tdb_jd_C};
+
+        if (std::binary_search(sorted.begin(), sorted.end(), record, byKey)) return;
+
+        std::lock_guard lock(mutex);
+
+        if (!appended.emplace(std::pair(kind, ordinal), tdb_jd_C).second) return;
+
+        journal.write(reinterpret_cast<const char*>(&record), sizeof(record));
+
+        if (!journal.flush()) throw std::runtime_error(std::format("EventCatalog: cannot append to {}", path.string()));
+    }
+
+    std::size_t EventCatalog::size() const {
+        std::lock_guard lock(mutex);
+
+        return sorted.size() + appended.size();
+    }
+
+    std::uint64_t EventCatalog::tag() const noexcept { return label; }
+}  // namespace astro
@@ -0,0 +1,135 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file catalog.h
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/09/09 19:42
+ * @brief
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#ifndef CATALOG_H
+#define CATALOG_H
+#pragma once
+
+#include "calender.h"
+#include "lea.h"
+#include "vsop.h"
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+
+namespace astro {
+    enum class EventKind : std::uint32_t {
+        ///< 序号k表示展开黄经差为360k的合朔
+        NewMoon,
+        ///< 序号k表示视黄经为termLongitude(立春) + 15k的节气
+        SolarTerm
+    };
+
+    struct CatalogRecord {
+        std::int64_t ordinal;
+        EventKind kind;
+        std::uint32_t reserved;
+        ///< 事件时刻(儒略世纪，TDB)
+        double tdb_jd_C;
+    };
+
+    struct CatalogHeader {
+        std::array<char, 8> magic;
+        std::uint32_t version;
+        std::uint32_t recordSize;
+        ///< 数据集与截断设置的哈希，不一致的目录不可复用
+        std::uint64_t tag;
+        ///< 紧随文件头的有序记录数，其后为本次打开以来追加的无序记录
+        std::uint64_t sorted;
+    };
+
+    extern const std::array<char, 8> CATALOG_MAGIC;
+
+    extern const std::uint32_t CATALOG_VERSION;
+
+    ///< 由编译后的级数与截断精度(角秒)求目录标签，任一系数不同标签即不同
+    std::uint64_t catalogTag(const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries, double precision = 0);
+
+    /**
+     * @brief 持久化的事件目录，按(种类, 序号)排序存储事件时刻
+     * @details 打开时把上次追加的记录并入有序区并重写文件，有序区以只读方式内存映射后二分查找；
+     *          此后求得的事件立即追加到文件末尾(写穿)并记入内存中的有序表
+     * @throw std::invalid_argument 文件中的目录标签与tag不同
+     * @throw std::runtime_error 文件不是事件目录或版本不符，或无法读写、替换
+     * @note 同一文件同时只能由一个EventCatalog打开。有未合并的记录时打开需要替换文件，
+     *       Windows上被映射的文件不能替换，文件已在别处打开时抛出std::runtime_error
+     * */
+    class EventCatalog {
+    public:
+        EventCatalog(const std::filesystem::path& path, std::uint64_t tag);
+
+        EventCatalog(const EventCatalog&) = delete;
+
+        EventCatalog& operator=(const EventCatalog&) = delete;
+
+        ~EventCatalog();
+
+        [[nodiscard]] std::optional<double> find(EventKind kind, std::int64_t ordinal) const;
+
+        ///< 记录已存在时忽略
+        void insert(EventKind kind, std::int64_t ordinal, double tdb_jd_C);
+
+        [[nodiscard]] std::size_t size() const;
+
+        [[nodiscard]] std::uint64_t tag() const noexcept;
+
+    private:
+        std::filesystem::path path;
+        std::uint64_t label;
+
+        ///< 映射的有序区
+        const void* mapping = nullptr;
+        std::size_t mappingSize{};
+        std::span<const CatalogRecord> sorted;
+
+        ///< 本次打开以来新增的记录
+        std::map<std::pair<EventKind, std::int64_t>, double> appended;
+        std::ofstream journal;
+
+        mutable std::mutex mutex;
+
+        void merge();
+
+        void map();
+
+        void unmap() noexcept;
+    };
+
+    ///< 先查目录，未收录时求解并写入目录；序号不确定时先以目录中的邻近事件判断，仍不确定才求值
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findNextNewMoon(double tdb_jd_C, const ElongationFunc& elongation, EventCatalog& catalog);
+
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findPrevNewMoon(double tdb_jd_C, const ElongationFunc& elongation, EventCatalog& catalog);
+
+    template<typename SolarFunc>
+        requires solarLongitudeCalcFunc<SolarFunc>
+    double findSolarTermForward(double tdb_jd_C, Term term, const SolarFunc& solarLong, EventCatalog& catalog);
+
+    template<typename SolarFunc>
+        requires solarLongitudeCalcFunc<SolarFunc>
+    double findSolarTermBackward(double tdb_jd_C, Term term, const SolarFunc& solarLong, EventCatalog& catalog);
+}  // namespace astro
+
+#include "catalog.hpp"
+
+#endif  // CATALOG_H
@@ -0,0 +1,113 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file catalog.hpp
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/09/09 19:42
+ * @brief
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#ifndef CATALOG_HPP
+#define CATALOG_HPP
+#pragma once
+
+#include <cmath>
+
+namespace astro {
+    ///< 目录中已有则直接返回，否则调用solve()求解并写入目录
+    template<typename Solve>
+    double catalogEvent(EventCatalog& catalog, EventKind kind, std::int64_t ordinal, const Solve& solve) {
+        if (const auto moment = catalog.find(kind, ordinal)) return *moment;
+
+        const auto moment = solve();
+        catalog.insert(kind, ordinal, moment);
+
+        return moment;
+    }
+
+    ///< 视黄经为longitude(展开值)的节气在目录中的序号
+    inline std::int64_t termOrdinal(const double longitude) { return std::llround((longitude - termLongitude(Term::StartOfSprint)) / 15); }
+
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findNextNewMoon(double tdb_jd_C, const ElongationFunc& elongation, EventCatalog& catalog) {
+        const auto mean = lea::meanAngleDistance(tdb_jd_C / 10);
+
+        auto ordinal = static_cast<std::int64_t>(std::floor(mean / 360 + LUNAR_PHASE_MARGIN)) + 1;
+
+        // 起点离合朔较近时序号由真黄经差决定，先看目录中最近的一次合朔在起点之前还是之后
+        if (std::abs(std::remainder(mean, 360.0)) <= ELONGATION_DEVIATION) {
+            const auto nearest = static_cast<std::int64_t>(std::round(mean / 360));
+
+            if (const auto moment = catalog.find(EventKind::NewMoon, nearest)) ordinal = *moment > tdb_jd_C ? nearest : nearest + 1;
+            else ordinal = static_cast<std::int64_t>(std::floor(elongation(tdb_jd_C).value / 360 + LUNAR_PHASE_MARGIN)) + 1;
+        }
+
+        return catalogEvent(catalog, EventKind::NewMoon, ordinal, [&] { return findElongation(tdb_jd_C, 360.0 * static_cast<double>(ordinal), elongation); });
+    }
+
+    template<typename ElongationFunc>
+        requires elongationCalcFunc<ElongationFunc>
+    double findPrevNewMoon(double tdb_jd_C, const ElongationFunc& elongation, EventCatalog& catalog) {
+        const auto mean = lea::meanAngleDistance(tdb_jd_C / 10);
+
+        auto ordinal = static_cast<std::int64_t>(std::ceil(mean / 360 - LUNAR_PHASE_MARGIN)) - 1;
+
+        if (std::abs(std::remainder(mean, 360.0)) <= ELONGATION_DEVIATION) {
+            const auto nearest = static_cast<std::int64_t>(std::round(mean / 360));
+
+            if (const auto moment = catalog.find(EventKind::NewMoon, nearest)) ordinal = *moment < tdb_jd_C ? nearest : nearest - 1;
+            else ordinal = static_cast<std::int64_t>(std::ceil(elongation(tdb_jd_C).value / 360 - LUNAR_PHASE_MARGIN)) - 1;
+        }
+
+        return catalogEvent(catalog, EventKind::NewMoon, ordinal, [&] { return findElongation(tdb_jd_C, 360.0 * static_cast<double>(ordinal), elongation); });
+    }
+
+    template<typename SolarFunc>
+        requires solarLongitudeCalcFunc<SolarFunc>
+    double findSolarTermForward(double tdb_jd_C, Term term, const SolarFunc& solarLong, EventCatalog& catalog) {
+        const auto longitude = termLongitude(term);
+        const auto mean      = meanSolarLongitude(tdb_jd_C);
+
+        auto cycles = std::floor((mean - longitude) / 360 + LUNAR_PHASE_MARGIN) + 1;
+
+        if (std::abs(std::remainder(mean - longitude, 360.0)) <= SOLAR_LONGITUDE_DEVIATION) {
+            const auto nearest = std::round((mean - longitude) / 360);
+
+            if (const auto moment = catalog.find(EventKind::SolarTerm, termOrdinal(longitude + 360 * nearest))) cycles = *moment > tdb_jd_C ? nearest : nearest + 1;
+            else cycles = std::floor((solarLong(tdb_jd_C).value - longitude) / 360 + LUNAR_PHASE_MARGIN) + 1;
+        }
+
+        const auto target = longitude + 360 * cycles;
+
+        return catalogEvent(catalog, EventKind::SolarTerm, termOrdinal(target), [&] { return findSolarLongitude(tdb_jd_C, target, solarLong); });
+    }
+
+    template<typename SolarFunc>
+        requires solarLongitudeCalcFunc<SolarFunc>
+    double findSolarTermBackward(double tdb_jd_C, Term term, const SolarFunc& solarLong, EventCatalog& catalog) {
+        const auto longitude = termLongitude(term);
+        const auto mean      = meanSolarLongitude(tdb_jd_C);
+
+        auto cycles = std::ceil((mean - longitude) / 360 - LUNAR_PHASE_MARGIN) - 1;
+
+        if (std::abs(std::remainder(mean - longitude, 360.0)) <= SOLAR_LONGITUDE_DEVIATION) {
+            const auto nearest = std::round((mean - longitude) / 360);
+
+            if (const auto moment = catalog.find(EventKind::SolarTerm, termOrdinal(longitude + 360 * nearest))) cycles = *moment < tdb_jd_C ? nearest : nearest - 1;
+            else cycles = std::ceil((solarLong(tdb_jd_C).value - longitude) / 360 - LUNAR_PHASE_MARGIN) - 1;
+        }
+
+        const auto target = longitude + 360 * cycles;
+
+        return catalogEvent(catalog, EventKind::SolarTerm, termOrdinal(target), [&] { return findSolarLongitude(tdb_jd_C, target, solarLong); });
+    }
+}  // namespace astro
+
+#endif  // CATALOG_HPP
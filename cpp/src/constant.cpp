@@ -209,41 +209,27 @@ namespace astro {
             return (357.528 + 35'999.05 * century) * std::numbers::pi / 180.0;
         }
 
-        double diffDelta(const double t) {
-            auto g = calcG(t);
-
-            auto diff = 35'999.05 * std::numbers::pi / 180.0;
-
-            return diff * 0.001658 * std::cos(g + 0.0167 * std::sin(g)) * (1 + 0.0167 * std::cos(g));
-        }
-
         double equationDelta(const double t) {
             auto g = calcG(t);
 
             return 0.001658 * std::sin(g + 0.0167 * std::sin(g));
         }
 
-        double TDB2TT(double t) {
-            while (true) {
-                const auto delta = equationDelta(t) / diffDelta(t);
+        // 以下儒略日以日计，各修正量以秒计，需除以一日的秒数
 
-                t -= delta;
-
-                if (std::abs(delta) < 1e-12) break;
-            }
-
-            return t;
-        }
+        // TDB - TT不超过2毫秒，以TDB代替TT求修正量引入的误差可以忽略
+        double TDB2TT(const double t) { return t - equationDelta(t) / 86400; }
 
-        double TT2TDB(const double t) { return t + equationDelta(t); }
+        double TT2TDB(const double t) { return t + equationDelta(t) / 86400; }
 
-        double TAI2TT(const double t) { return t + 32.184; }
+        double TAI2TT(const double t) { return t + 32.184 / 86400; }
 
-        double TT2TAI(const double t) { return t - 32.184; }
+        double TT2TAI(const double t) { return t - 32.184 / 86400; }
 
-        double UTC2TAI(const double t) { return t + leapSecond(t); }
+        // leapSecond给出ΔT = TT - UTC，TAI - UTC = ΔT - 32.184
+        double UTC2TAI(const double t) { return t + (leapSecond(t) - 32.184) / 86400; }
 
-        double TAI2UTC(const double t) { return t - leapSecond(t); }
+        double TAI2UTC(const double t) { return t - (leapSecond(t) - 32.184) / 86400; }
 
         double UTC2TT(const double t) { return TAI2TT(UTC2TAI(t)); }
 
@@ -0,0 +1,127 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file frame.cpp
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/08/20 21:07
+ * @brief 直角坐标与参考架旋转
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#include "frame.h"
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+namespace astro {
+    namespace {
+        constexpr double ARCSEC = std::numbers::pi / 180 / 3600;
+
+        // 绕x轴旋转坐标系
+        Matrix3 rotationX(const double angle) {
+            const auto c = std::cos(angle), s = std::sin(angle);
+
+            return {{{1, 0, 0}, {0, c, s}, {0, -s, c}}};
+        }
+
+        // 绕z轴旋转坐标系
+        Matrix3 rotationZ(const double angle) {
+            const auto c = std::cos(angle), s = std::sin(angle);
+
+            return {{{c, s, 0}, {-s, c, 0}, {0, 0, 1}}};
+        }
+
+        // 以J2000黄道为中转，from -> J2000黄道 与 J2000黄道 -> to
+        Matrix3 toEclipticJ2000(const Frame from, const double tdb_jd_C) {
+            switch (from) {
+                case Frame::EclipticJ2000: return IDENTITY;
+                case Frame::ICRS: return transpose(ECLIPTIC_TO_ICRS);
+                case Frame::EclipticOfDate: return transpose(eclipticPrecession(tdb_jd_C));
+                default: throw std::invalid_argument("toEclipticJ2000: unknown frame");
+            }
+        }
+
+        Matrix3 fromEclipticJ2000(const Frame to, const double tdb_jd_C) {
+            switch (to) {
+                case Frame::EclipticJ2000: return IDENTITY;
+                case Frame::ICRS: return ECLIPTIC_TO_ICRS;
+                case Frame::EclipticOfDate: return eclipticPrecession(tdb_jd_C);
+                default: throw std::invalid_argument("fromEclipticJ2000: unknown frame");
+            }
+        }
+    }  // namespace
+
+    constexpr Matrix3 IDENTITY = {{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}};
+
+    // VSOP2013.f: ε = 23°26'21.41136", φ = -0.05188"
+    const Matrix3 ECLIPTIC_TO_ICRS = [] {
+        const auto eps = (23.0 + 26.0 / 60.0 + 21.41136 / 3600.0) * std::numbers::pi / 180;
+        const auto phi = -0.05188 * ARCSEC;
+
+        const auto ce = std::cos(eps), se = std::sin(eps);
+        const auto cp = std::cos(phi), sp = std::sin(phi);
+
+        return Matrix3{{{cp, -sp * ce, sp * se}, {sp, cp * ce, -cp * se}, {0, se, ce}}};
+    }();
+
+    Matrix3 multiply(const Matrix3& a, const Matrix3& b) {
+        Matrix3 result{};
+
+        for (std::size_t i{}; i < 3; ++i)
+            for (std::size_t j{}; j < 3; ++j) result[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j];
+
+        return result;
+    }
+
+    Matrix3 transpose(const Matrix3& m) { return {{{m[0][0], m[1][0], m[2][0]}, {m[0][1], m[1][1], m[2][1]}, {m[0][2], m[1][2], m[2][2]}}}; }
+
+    Vector3 rotate(const Matrix3& m, const Vector3& v) {
+        return {m[0][0] * v[0] + m[0][1] * v[1] + m[0][2] * v[2], m[1][0] * v[0] + m[1][1] * v[1] + m[1][2] * v[2], m[2][0] * v[0] + m[2][1] * v[1] + m[2][2] * v[2]};
+    }
+
+    StateVector rotate(const Matrix3& m, const StateVector& state) { return {rotate(m, state.position), rotate(m, state.velocity)}; }
+
+    void rotate(const Matrix3& m, std::span<StateVector> states) {
+        for (auto& state : states) state = rotate(m, state);
+    }
+
+    void rotate(std::span<const Matrix3> matrices, std::span<StateVector> states) {
+        if (matrices.empty() || states.size() % matrices.size()) throw std::invalid_argument("rotate: states must be grouped by epoch");
+
+        // states按历元分组: states[epoch * bodies + body]
+        const auto bodies = states.size() / matrices.size();
+
+        for (std::size_t i{}; i < matrices.size(); ++i) rotate(matrices[i], states.subspan(i * bodies, bodies));
+    }
+
+    Matrix3 eclipticPrecession(const double tdb_jd_C) {
+        // Lieske(1977)黄道岁差，起始历元J2000 (Meeus 21.5)
+        const auto t = tdb_jd_C;
+
+        const auto eta = ((0.000060 * t - 0.03302) * t + 47.0029) * t * ARCSEC;
+        const auto Pi  = 174.876384 * std::numbers::pi / 180 + (0.03536 * t - 869.8089) * t * ARCSEC;
+        const auto p   = ((-0.000006 * t + 1.11113) * t + 5029.0966) * t * ARCSEC;
+
+        return multiply(multiply(rotationZ(-(Pi + p)), rotationX(eta)), rotationZ(Pi));
+    }
+
+    Matrix3 frameRotation(const Frame from, const Frame to, const double tdb_jd_C) {
+        if (from == to) return IDENTITY;
+
+        return multiply(fromEclipticJ2000(to, tdb_jd_C), toEclipticJ2000(from, tdb_jd_C));
+    }
+
+    std::vector<Matrix3> frameRotations(const Frame from, const Frame to, std::span<const double> tdb_jd_C) {
+        std::vector<Matrix3> result;
+        result.reserve(tdb_jd_C.size());
+
+        for (const auto t : tdb_jd_C) result.push_back(frameRotation(from, to, t));
+
+        return result;
+    }
+}  // namespace astro
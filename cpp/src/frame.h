@@ -0,0 +1,66 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file frame.h
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/08/20 21:07
+ * @brief 直角坐标与参考架旋转
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#ifndef FRAME_H
+#define FRAME_H
+#pragma once
+
+#include <array>
+#include <span>
+#include <vector>
+
+namespace astro {
+    using Vector3 = std::array<double, 3>;
+
+    using Matrix3 = std::array<Vector3, 3>;
+
+    struct StateVector {
+        Vector3 position;
+        Vector3 velocity;
+    };
+
+    enum class Frame {
+        ///< J2000动力学黄道与春分点(VSOP2013的参考架)
+        EclipticJ2000,
+        ///< 国际天球参考系(赤道)
+        ICRS,
+        ///< 瞬时黄道与平春分点
+        EclipticOfDate,
+    };
+
+    extern const Matrix3 IDENTITY;
+
+    extern const Matrix3 ECLIPTIC_TO_ICRS;
+
+    Matrix3 multiply(const Matrix3& a, const Matrix3& b);
+
+    Matrix3 transpose(const Matrix3& m);
+
+    Vector3 rotate(const Matrix3& m, const Vector3& v);
+
+    StateVector rotate(const Matrix3& m, const StateVector& state);
+
+    void rotate(const Matrix3& m, std::span<StateVector> states);
+
+    void rotate(std::span<const Matrix3> matrices, std::span<StateVector> states);
+
+    Matrix3 eclipticPrecession(double tdb_jd_C);
+
+    Matrix3 frameRotation(Frame from, Frame to, double tdb_jd_C);
+
+    std::vector<Matrix3> frameRotations(Frame from, Frame to, std::span<const double> tdb_jd_C);
+}  // namespace astro
+
+#endif  // FRAME_H
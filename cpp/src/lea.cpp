@@ -14,46 +14,114 @@
  * @copyright CC BY-NC-SA 2025. All rights reserved.
  * */
 #include "lea.h"
+#include "trig.h"
 #include "utils.h"
+#include <algorithm>
 #include <cmath>
+#include <format>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
 
 namespace astro::lea {
-    double meanLongitude(double t) { return 218.31664563 + (173256437.2370470 * t - 527.90 * std::pow(t, 2) + 6.6655 * std::pow(t, 3) - 0.5522 * std::pow(t, 4)) / 3600; }
+    // 常数项(度)与1~4次项系数(角秒/千年^n)，Simon et al. (1994)，顺序同COEFFICIENTS_TABLE
+    constexpr std::array<std::array<double, 5>, 14> ARGUMENT_POLYNOMIALS = {{
+        {134.96340251, 17179159232.178, 3187.92, 51.635, -2.4470},       // l
+        {357.52910918, 1295965810.481, -55.32, 0.136, -0.1149},          // l'
+        {93.27209062, 17395272628.478, -1275.12, -1.037, 0.0417},        // F
+        {297.85019547, 16029616012.090, -637.06, 6.593, -0.3169},        // D
+        {125.04455501, -69679193.631, 636.02, 7.625, -0.3586},           // Ω
+        {252.25090552, 5381016286.88982, -1.92789, 0.00639, 0},          // 水星
+        {181.97980085, 2106641364.33548, 0.59381, -0.00627, 0},          // 金星
+        {100.46645683, 1295977422.83429, -2.04411, -0.00523, 0},         // 地月系
+        {355.43299958, 689050774.93988, 0.94264, -0.01043, 0},           // 火星
+        {34.35151874, 109256603.77991, -30.60378, 0.05706, 0.04667},     // 木星
+        {50.07744430, 43996098.55732, 75.61614, -0.16618, -0.11484},     // 土星
+        {314.05500511, 15424811.93933, -1.75083, 0.02156, 0},            // 天王星
+        {304.34866548, 7865503.20744, 0.21103, -0.00895, 0},             // 海王星
+        {0, 50288.2, 111.2022, 0.0773, -0.2353}                          // pA
+    }};
 
-    double ascendingNodeLongitude(double t) { return 125.04455501 - (696791.937631 * t - 636.02 * std::pow(t, 2) - 7.625 * std::pow(t, 3) + 0.3586 * std::pow(t, 4)) / 3600; }
+    namespace {
+        constexpr std::array<double, 5> MEAN_LONGITUDE_POLYNOMIAL = {218.31664563, 17325643723.0470, -527.90, 6.665, -0.5522};
 
-    double meanAngleDistance(double t) { return 297.85019547 + (16029616012.090 * t - 637.06 * std::pow(t, 2) + 6.593 * std::pow(t, 3) - 0.3169 * std::pow(t, 4)) / 3600; }
+        double polynomialArgument(const std::array<double, 5>& c, const double t) { return c[0] + (((c[4] * t + c[3]) * t + c[2]) * t + c[1]) * t / 3600; }
 
-    double sunMeanAnomaly(double t) { return 357.52910918 + (1295965810.481 * t - 55.32 * std::pow(t, 2) + 0.136 * std::pow(t, 3) - 0.1149 * std::pow(t, 4)) / 3600; }
+        // 角秒/千年
+        double polynomialRate(const std::array<double, 5>& c, const double t) { return c[1] + t * (2 * c[2] + t * (3 * c[3] + t * 4 * c[4])); }
+    }  // namespace
 
-    double moonMeanAnomaly(double t) { return 134.96340251 + (17179159232.178 * t + 3187.92 * std::pow(t, 2) + 51.635 * std::pow(t, 3) - 2.4470 * std::pow(t, 4)) / 3600; }
+    double meanLongitude(double t) { return polynomialArgument(MEAN_LONGITUDE_POLYNOMIAL, t); }
 
-    double moonMeanLongitude(double t) { return 93.27209062 + (17395272628.478 * t - 1275.12 * std::pow(t, 2) - 1.037 * std::pow(t, 3) + 0.0417 * std::pow(t, 4)) / 3600; }
+    double meanLongitudeRate(double t) { return polynomialRate(MEAN_LONGITUDE_POLYNOMIAL, t) / 3600; }
 
-    double lambdaMercury(double t) { return 252.25090552 + (5381016286.88982 * t - 1.92789 * std::pow(t, 2) + 0.00639 * std::pow(t, 3)) / 3600; }
+    double ascendingNodeLongitude(double t) { return polynomialArgument(ARGUMENT_POLYNOMIALS[4], t); }
 
-    double lambdaVenus(double t) { return 181.97980085 + (2106641364.33548 * t + 0.59381 * std::pow(t, 2) - 0.00627 * std::pow(t, 3)) / 3600; }
+    double meanAngleDistance(double t) { return polynomialArgument(ARGUMENT_POLYNOMIALS[3], t); }
 
-    double lambdaEarthMoon(double t) { return 100.46645683 + (1295977422.83429 * t - 2.04411 * std::pow(t, 2) - 0.00523 * std::pow(t, 3)) / 3600; }
+    double sunMeanAnomaly(double t) { return polynomialArgument(ARGUMENT_POLYNOMIALS[1], t); }
 
-    double lambdaMars(double t) { return 355.43299958 + (689050774.93988 * t + 0.94264 * std::pow(t, 2) - 0.01043 * std::pow(t, 3)) / 3600; }
+    double moonMeanAnomaly(double t) { return polynomialArgument(ARGUMENT_POLYNOMIALS[0], t); }
 
-    double lambdaJupiter(double t) { return 34.35151874 + (109256603.77991 * t - 30.60378 * std::pow(t, 2) + 0.05706 * std::pow(t, 3) + 0.04667 * std::pow(t, 4)) / 3600; }
+    double moonMeanLongitude(double t) { return polynomialArgument(ARGUMENT_POLYNOMIALS[2], t); }
 
-    double lambdaSaturn(double t) { return 50.07744430 + (43996098.55732 * t + 75.61614 * std::pow(t, 2) - 0.16618 * std::pow(t, 3) - 0.11484 * std::pow(t, 4)) / 3600; }
+    double lambdaMercury(double t) { return polynomialArgument(ARGUMENT_POLYNOMIALS[5], t); }
 
-    double lambdaUranus(double t) { return 314.05500511 + (15424811.93933 * t - 1.75083 * std::pow(t, 2) + 0.02156 * std::pow(t, 3)) / 3600; }
+    double lambdaVenus(double t) { return polynomialArgument(ARGUMENT_POLYNOMIALS[6], t); }
 
-    double lambdaNeptune(double t) { return 304.34866548 + (78655032.20744 * t + 0.21103 * std::pow(t, 2) - 0.00895 * std::pow(t, 3)) / 3600; }
+    double lambdaEarthMoon(double t) { return polynomialArgument(ARGUMENT_POLYNOMIALS[7], t); }
 
-    double generalPrecessionLongitude(double t) { return (50288.200 * t + 111.202 * std::pow(t, 2) + 0.0773 * std::pow(t, 3) - 0.2353 * std::pow(t, 4)) / 3600; }
+    double lambdaMars(double t) { return polynomialArgument(ARGUMENT_POLYNOMIALS[8], t); }
 
+    double lambdaJupiter(double t) { return polynomialArgument(ARGUMENT_POLYNOMIALS[9], t); }
+
+    double lambdaSaturn(double t) { return polynomialArgument(ARGUMENT_POLYNOMIALS[10], t); }
+
+    double lambdaUranus(double t) { return polynomialArgument(ARGUMENT_POLYNOMIALS[11], t); }
+
+    double lambdaNeptune(double t) { return polynomialArgument(ARGUMENT_POLYNOMIALS[12], t); }
+
+    double generalPrecessionLongitude(double t) { return polynomialArgument(ARGUMENT_POLYNOMIALS[13], t); }
+
+    std::array<double, 14> fundamentalRevolutions(double t) {
+        std::array<double, 14> result{};
+
+        // 一次项以周为单位精确约化，高次项量级很小直接相加
+        for (std::size_t i{}; i < result.size(); ++i) {
+            const auto& c = ARGUMENT_POLYNOMIALS[i];
+
+            result[i] = fraction(revolutions(c[0] / 360, c[1] / 1296000, t) + ((c[4] * t + c[3]) * t + c[2]) * t * t / 1296000);
+        }
+
+        return result;
+    }
+
+    std::array<double, 14> fundamentalArguments(double t) {
+        auto result = fundamentalRevolutions(t);
+
+        for (auto& x : result) x *= 2 * std::numbers::pi;
+
+        return result;
+    }
+
+    std::array<double, 14> fundamentalRates(double t) {
+        std::array<double, 14> result{};
+
+        for (std::size_t i{}; i < result.size(); ++i) result[i] = polynomialRate(ARGUMENT_POLYNOMIALS[i], t) / 1296000;
+
+        return result;
+    }
+
+    // 与数据文件中乘数的列顺序一致: l, l', F, D, Ω, 八大行星平黄经, pA
     const std::vector<std::function<double(double)>> COEFFICIENTS_TABLE = {
-        ascendingNodeLongitude, meanAngleDistance, sunMeanAnomaly, moonMeanAnomaly, moonMeanLongitude, lambdaMercury, lambdaVenus,
-        lambdaEarthMoon,        lambdaMars,        lambdaJupiter,  lambdaSaturn,    lambdaUranus,      lambdaNeptune, generalPrecessionLongitude
+        moonMeanAnomaly, sunMeanAnomaly, moonMeanLongitude, meanAngleDistance, ascendingNodeLongitude, lambdaMercury, lambdaVenus,
+        lambdaEarthMoon, lambdaMars,     lambdaJupiter,     lambdaSaturn,      lambdaUranus,           lambdaNeptune, generalPrecessionLongitude
     };
 
     long double calcOmega(double t, const std::vector<std::shared_ptr<reader::Literal>>& data) {
+        // 在周数空间中组合各幅角，结果落在[0, 360)
+        const auto revolution = fundamentalRevolutions(t);
+
         long double result{};
 
         for (std::size_t i{}; i < data.size(); ++i)
@@ -61,22 +129,27 @@ namespace astro::lea {
                 [&]<typename T>(T&& arg) -> double {
                     if constexpr (std::is_same_v<T, std::string>) {
                         std::cerr << "Waring: " << arg << " is not a valid term in the LEA model. It will be ignored." << std::endl;
-                        return std::stod(arg) * COEFFICIENTS_TABLE[i](t);
+                        return std::stod(arg) * revolution[i];
                     } else
-                        return arg * COEFFICIENTS_TABLE[i](t);
+                        return arg * revolution[i];
                 },
                 data[i]->value()
             );
 
-        return result;
+        return fraction(static_cast<double>(result)) * 360;
     }
 
     long double calcSeries(double t, const std::shared_ptr<reader::Term>& term, const std::function<long double(long double)>& tragFunc) {
         long double result{};
 
-        auto omega = calcOmega(t, term->coefficients);
+        // 幅角与泊松项均以千年为时间单位
+        const auto tm = t / 10;
+
+        auto omega = calcOmega(tm, term->coefficients);
 
-        for (std::size_t i{}; i < term->amplitudes.size(); ++i) result += std::get<double>(term->amplitudes[i]->value()) * tragFunc(omega + std::get<double>(term->phases[i]->value()));
+        for (std::size_t i{}; i < term->amplitudes.size(); ++i)
+            result += std::get<double>(term->amplitudes[i]->value()) * binPow(tm, static_cast<int>(i))
+                    * tragFunc((omega + std::get<double>(term->phases[i]->value())) * std::numbers::pi_v<long double> / 180);
 
         return result;
     }
@@ -94,7 +167,8 @@ namespace astro::lea {
 
         for (const auto& term : data.terms) result += calcSeries(t, term, [](long double x) { return std::sin(x); });
 
-        return meanLongitude(t) + result;
+        // 级数单位为角秒
+        return meanLongitude(t / 10) + result / 3600;
     }
 
     long double calcTrueLatitude(double t, const reader::Data& data) {
@@ -102,11 +176,559 @@ namespace astro::lea {
 
         for (const auto& term : data.terms) result += calcSeries(t, term, [](long double x) { return std::sin(x); });
 
-        return result;
+        return result / 3600;
     }
 
     GeoCoord<long double, long double, long double> lea406(double tdb_jd_C, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData) {
         return {calcGeocentricDistance(tdb_jd_C, rData), calcTrueLongitude(tdb_jd_C, vData), calcTrueLatitude(tdb_jd_C, uData)};
     }
 
+    constexpr double MEAN_DISTANCE = 385000.5;
+
+    CompiledSeries compile(const reader::Data& data) {
+        struct Row {
+            std::array<std::int8_t, 14> multipliers;
+            std::array<double, 3> amplitudes;
+            std::array<double, 3> phases;
+            double bound;
+        };
+
+        std::vector<Row> rows;
+        rows.reserve(data.terms.size());
+
+        const auto toDouble = []<typename T>(T&& arg) -> double {
+            if constexpr (std::is_same_v<std::decay_t<T>, std::string>)
+                return std::stod(arg);
+            else
+                return arg;
+        };
+
+        for (const auto& term : data.terms) {
+            Row row{};
+
+            for (std::size_t i{}; i < term->coefficients.size() && i < row.multipliers.size(); ++i) {
+                const auto multiplier = static_cast<int>(std::visit(toDouble, term->coefficients[i]->value()));
+
+                if (multiplier < std::numeric_limits<std::int8_t>::min() || multiplier > std::numeric_limits<std::int8_t>::max())
+                    throw std::out_of_range(std::format("Multiplier {} is out of the range of int8", multiplier));
+
+                row.multipliers[i] = static_cast<std::int8_t>(multiplier);
+            }
+
+            for (std::size_t i{}; i < term->amplitudes.size() && i < row.amplitudes.size(); ++i) {
+                row.amplitudes[i] = std::visit(toDouble, term->amplitudes[i]->value());
+                // 相位在加载时转为弧度
+                row.phases[i] = std::visit(toDouble, term->phases[i]->value()) * std::numbers::pi / 180;
+                row.bound += std::abs(row.amplitudes[i]);
+            }
+
+            rows.push_back(row);
+        }
+
+        // 按一千年处的最大贡献降序排列，便于按精度截断
+        std::ranges::sort(rows, std::greater{}, &Row::bound);
+
+        CompiledSeries result;
+        result.tailAmplitude.assign(rows.size() + 1, {});
+
+        for (std::size_t k = rows.size(); k-- > 0;)
+            for (std::size_t i{}; i < 3; ++i) result.tailAmplitude[k][i] = result.tailAmplitude[k + 1][i] + std::abs(rows[k].amplitudes[i]);
+
+        // A·f(arg+φ)展开为A·cosφ与A·sinφ对sin(arg)、cos(arg)的线性组合，每项只需一次sincos
+        for (const auto& row : rows) {
+            std::array<double, 3> cosCoefficient{}, sinCoefficient{};
+
+            for (std::size_t i{}; i < 3; ++i) {
+                cosCoefficient[i] = row.amplitudes[i] * std::cos(row.phases[i]);
+                sinCoefficient[i] = row.amplitudes[i] * std::sin(row.phases[i]);
+            }
+
+            result.multipliers.push_back(row.multipliers);
+            result.cosCoefficients.push_back(cosCoefficient);
+            result.sinCoefficients.push_back(sinCoefficient);
+        }
+
+        return result;
+    }
+
+    std::size_t truncation(const CompiledSeries& series, const double t, const double tolerance) {
+        if (tolerance <= 0) return series.multipliers.size();
+
+        const auto tm = std::abs(t / 10);
+
+        // 剩余项在该历元的贡献上界 A0 + A1|t| + A2t^2 随下标单调不增
+        return std::ranges::partition_point(series.tailAmplitude, [&](const std::array<double, 3>& tail) { return tail[0] + tm * (tail[1] + tm * tail[2]) > tolerance; })
+             - series.tailAmplitude.begin();
+    }
+
+    namespace {
+        /**
+         * @brief 截断后级数的和，Real为累加与返回的类型
+         * @details Real为long double时按Summation::LongDouble逐项累加；为double时按summation做补偿累加，各项、部分和与合并全程为double
+         * */
+        template<typename Real, Trig trig>
+        Real sumSeries(double t, const CompiledSeries& series, const double tolerance, const Summation summation, const Parallelism& parallelism) {
+            const auto tm = t / 10;
+
+            // 各基本幅角每个历元只计算一次
+            const auto revolution = fundamentalRevolutions(tm);
+
+            const auto count = truncation(series, t, tolerance);
+
+            // Σ A_i·t^i·f(arg+φ_i) = C(t)·sin(arg) + S(t)·cos(arg)  (f = sin)
+            //                      = C(t)·cos(arg) - S(t)·sin(arg)  (f = cos)
+            // 其中C(t) = Σ A_i·cos(φ_i)·t^i, S(t) = Σ A_i·sin(φ_i)·t^i，按Horner形式求值
+            const auto term = [&](const std::size_t k) {
+                double cycles{};
+                for (std::size_t i{}; i < revolution.size(); ++i) cycles += series.multipliers[k][i] * revolution[i];
+
+                const auto arg = fraction(cycles) * 2 * std::numbers::pi;
+
+                const auto& c = series.cosCoefficients[k];
+                const auto& s = series.sinCoefficients[k];
+
+                const double C = c[0] + tm * (c[1] + tm * c[2]);
+                const double S = s[0] + tm * (s[1] + tm * s[2]);
+
+                const auto [sinArg, cosArg] = sincos(arg);
+
+                if constexpr (trig == Trig::Sin)
+                    return C * sinArg + S * cosArg;
+                else
+                    return C * cosArg - S * sinArg;
+            };
+
+            const auto sum = [&](const std::size_t begin, const std::size_t end) -> Real {
+                if constexpr (std::is_same_v<Real, long double>) {
+                    long double result{};
+
+                    for (std::size_t k = begin; k < end; ++k) result += term(k);
+
+                    return result;
+                }
+                else if (summation == Summation::Neumaier) {
+                    NeumaierSum result;
+
+                    for (std::size_t k = begin; k < end; ++k) result.add(term(k));
+
+                    return result.value();
+                }
+                else {
+                    // 先求出各项再整体分块累加
+                    std::vector<double> values(end - begin);
+
+                    for (std::size_t k = begin; k < end; ++k) values[k - begin] = term(k);
+
+                    return blockedSum(values);
+                }
+            };
+
+            if (!parallelism.pool || count < parallelism.threshold) return sum(0, count);
+
+            // 分块方式只取决于项数，各块部分和按块序合并，线程数不影响结果
+            const auto chunks = (count + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+
+            std::vector<Real> partial(chunks);
+
+            parallelism.pool->parallelFor(chunks, [&](const std::size_t chunk) { partial[chunk] = sum(chunk * PARALLEL_CHUNK, std::min(count, (chunk + 1) * PARALLEL_CHUNK)); });
+
+            if constexpr (std::is_same_v<Real, long double>) {
+                long double result{};
+
+                for (const auto x : partial) result += x;
+
+                return result;
+            }
+            else return neumaierSum(partial);
+        }
+    }  // namespace
+
+    template<Trig trig, typename Real>
+    Real calcSeries(double t, const CompiledSeries& series, const double tolerance, const Summation summation, const Parallelism& parallelism) {
+        if (summation != Summation::LongDouble) return sumSeries<double, trig>(t, series, tolerance, summation, parallelism);
+
+        if constexpr (std::is_same_v<Real, long double>)
+            return sumSeries<long double, trig>(t, series, tolerance, summation, parallelism);
+        else
+            throw std::invalid_argument("calcSeries: Summation::LongDouble requires a long double result");
+    }
+
+    template long double calcSeries<Trig::Sin, long double>(double t, const CompiledSeries& series, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    template long double calcSeries<Trig::Cos, long double>(double t, const CompiledSeries& series, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    template double calcSeries<Trig::Sin, double>(double t, const CompiledSeries& series, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    template double calcSeries<Trig::Cos, double>(double t, const CompiledSeries& series, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    namespace {
+        /**
+         * @brief 各基本幅角在t处以步长h的一阶、二阶前向差分(周)
+         * @details 由各阶导数展开直接求出，避免相邻历元的幅角相减:
+         *          p(t+h) - p(t) = p'h + p''h^2/2 + p'''h^3/6 + p''''h^4/24,
+         *          p(t+2h) - 2p(t+h) + p(t) = p''h^2 + p'''h^3 + 7p''''h^4/12，对四次多项式是精确的
+         * */
+        std::array<std::array<double, 14>, 2> revolutionDifferences(const double t, const double h) {
+            std::array<std::array<double, 14>, 2> result{};
+
+            for (std::size_t i{}; i < ARGUMENT_POLYNOMIALS.size(); ++i) {
+                const auto& c = ARGUMENT_POLYNOMIALS[i];
+
+                const auto d1 = c[1] + t * (2 * c[2] + t * (3 * c[3] + t * 4 * c[4]));
+                const auto d2 = 2 * c[2] + t * (6 * c[3] + t * 12 * c[4]);
+                const auto d3 = 6 * c[3] + t * 24 * c[4];
+                const auto d4 = 24 * c[4];
+
+                result[0][i] = h * (d1 + h * (d2 / 2 + h * (d3 / 6 + h * d4 / 24))) / 1296000;
+                result[1][i] = h * h * (d2 + h * (d3 + h * d4 * 7 / 12)) / 1296000;
+            }
+
+            return result;
+        }
+    }  // namespace
+
+    template<Trig trig>
+    void calcSeries(const double t0, const double step, const CompiledSeries& series, const std::span<double> values, const double tolerance) {
+        // 锚定间隔由步长折算，零步长无法折算
+        if (step == 0 || !std::isfinite(step)) throw std::invalid_argument(std::format("calcSeries: step {} must be finite and non-zero", step));
+
+        std::ranges::fill(values, 0.0);
+
+        if (values.empty()) return;
+
+        const auto tm    = t0 / 10;
+        const auto stepm = step / 10;
+
+        // 截断按区间内|t|最大的端点确定，对整个序列都成立
+        const auto count = truncation(series, std::max(std::abs(t0), std::abs(t0 + (values.size() - 1) * step)), tolerance);
+
+        const auto interval = std::clamp(static_cast<std::size_t>(RECURRENCE_SPAN / std::abs(stepm)), std::size_t{1}, RECURRENCE_ANCHOR_INTERVAL);
+
+        std::vector<double> phase(count), increment(count), curvature(count);
+        PhaseRecurrence recurrence;
+
+        for (std::size_t k{}; k < values.size(); ++k) {
+            const auto t = tm + k * stepm;
+
+            if (k % interval == 0) {
+                const auto revolution                 = fundamentalRevolutions(t);
+                const auto [difference1, difference2] = revolutionDifferences(t, stepm);
+
+                for (std::size_t j{}; j < count; ++j) {
+                    double cycles{}, d1{}, d2{};
+
+                    for (std::size_t i{}; i < revolution.size(); ++i) {
+                        cycles += series.multipliers[j][i] * revolution[i];
+                        d1 += series.multipliers[j][i] * difference1[i];
+                        d2 += series.multipliers[j][i] * difference2[i];
+                    }
+
+                    phase[j] = cycles, increment[j] = d1, curvature[j] = d2;
+                }
+
+                recurrence.anchor(phase, increment, curvature);
+            }
+            else
+                recurrence.advance();
+
+            const auto sinArg = recurrence.sin();
+            const auto cosArg = recurrence.cos();
+
+            double result{};
+
+            for (std::size_t j{}; j < count; ++j) {
+                const auto& c = series.cosCoefficients[j];
+                const auto& s = series.sinCoefficients[j];
+
+                const double C = c[0] + t * (c[1] + t * c[2]);
+                const double S = s[0] + t * (s[1] + t * s[2]);
+
+                if constexpr (trig == Trig::Sin)
+                    result += C * sinArg[j] + S * cosArg[j];
+                else
+                    result += C * cosArg[j] - S * sinArg[j];
+            }
+
+            values[k] = result;
+        }
+    }
+
+    template void calcSeries<Trig::Sin>(double t0, double step, const CompiledSeries& series, std::span<double> values, double tolerance);
+
+    template void calcSeries<Trig::Cos>(double t0, double step, const CompiledSeries& series, std::span<double> values, double tolerance);
+
+    template<Trig trig>
+    double calcSeriesRate(const double t, const CompiledSeries& series, const double tolerance) {
+        const auto tm = t / 10;
+
+        const auto revolution = fundamentalRevolutions(tm);
+        const auto rate       = fundamentalRates(tm);
+
+        const auto count = truncation(series, t, tolerance);
+
+        double result{};
+
+        for (std::size_t k{}; k < count; ++k) {
+            double cycles{}, frequency{};
+
+            for (std::size_t i{}; i < revolution.size(); ++i) {
+                cycles += series.multipliers[k][i] * revolution[i];
+                frequency += series.multipliers[k][i] * rate[i];
+            }
+
+            const auto [sinArg, cosArg] = sincos(fraction(cycles) * 2 * std::numbers::pi);
+
+            const auto& c = series.cosCoefficients[k];
+            const auto& s = series.sinCoefficients[k];
+
+            const double C  = c[0] + tm * (c[1] + tm * c[2]);
+            const double S  = s[0] + tm * (s[1] + tm * s[2]);
+            const double dC = c[1] + 2 * tm * c[2];
+            const double dS = s[1] + 2 * tm * s[2];
+
+            const auto omega = frequency * 2 * std::numbers::pi;
+
+            if constexpr (trig == Trig::Sin)
+                result += dC * sinArg + dS * cosArg + omega * (C * cosArg - S * sinArg);
+            else
+                result += dC * cosArg - dS * sinArg - omega * (C * sinArg + S * cosArg);
+        }
+
+        // 每千年 -> 每儒略世纪
+        return result / 10;
+    }
+
+    template double calcSeriesRate<Trig::Sin>(double t, const CompiledSeries& series, double tolerance);
+
+    template double calcSeriesRate<Trig::Cos>(double t, const CompiledSeries& series, double tolerance);
+
+    template<Trig trig>
+    void calcSeries(const std::span<const double> t, const CompiledSeries& series, const std::span<double> values, const std::span<double> rates, const double tolerance) {
+        if (values.size() != t.size() || (!rates.empty() && rates.size() != t.size()))
+            throw std::invalid_argument(std::format("calcSeries: {} epochs but {} values and {} rates", t.size(), values.size(), rates.size()));
+
+        std::ranges::fill(values, 0.0);
+        std::ranges::fill(rates, 0.0);
+
+        if (t.empty()) return;
+
+        const auto lanes = t.size();
+
+        // 各历元按自身的|t|截断，与单历元求值取相同的项；逐项循环到各历元中最多的项数为止
+        std::vector<std::size_t> laneCount(lanes);
+        for (std::size_t l{}; l < lanes; ++l) laneCount[l] = truncation(series, t[l], tolerance);
+
+        const auto count = std::ranges::max(laneCount);
+
+        // 各历元的基本幅角与变化率按幅角主序存放(下标i·lanes + l)，逐项求值时按历元连续访问
+        std::vector<double> tm(lanes), revolution(14 * lanes), frequency(rates.empty() ? 0 : 14 * lanes);
+
+        for (std::size_t l{}; l < lanes; ++l) {
+            tm[l] = t[l] / 10;
+
+            const auto r = fundamentalRevolutions(tm[l]);
+            for (std::size_t i{}; i < r.size(); ++i) revolution[i * lanes + l] = r[i];
+
+            if (rates.empty()) continue;
+
+            const auto f = fundamentalRates(tm[l]);
+            for (std::size_t i{}; i < f.size(); ++i) frequency[i * lanes + l] = f[i];
+        }
+
+        std::vector<double> arg(lanes), sinArg(lanes), cosArg(lanes), omega(lanes), active(lanes);
+
+        for (std::size_t j{}; j < count; ++j) {
+            const auto& multiplier = series.multipliers[j];
+
+            std::ranges::fill(arg, 0.0);
+            std::ranges::fill(omega, 0.0);
+
+            // 大多数乘数为0，跳过后每项只剩少数几次按历元连续的乘加
+            for (std::size_t i{}; i < multiplier.size(); ++i) {
+                if (!multiplier[i]) continue;
+
+                const double m = multiplier[i];
+
+                for (std::size_t l{}; l < lanes; ++l) arg[l] += m * revolution[i * lanes + l];
+
+                if (rates.empty()) continue;
+
+                for (std::size_t l{}; l < lanes; ++l) omega[l] += m * frequency[i * lanes + l];
+            }
+
+            // 已截断的历元以0权重跳过该项，历元方向的循环保持无分支
+            for (std::size_t l{}; l < lanes; ++l) {
+                arg[l]    = fraction(arg[l]) * 2 * std::numbers::pi;
+                omega[l]  = omega[l] * 2 * std::numbers::pi;
+                active[l] = j < laneCount[l] ? 1.0 : 0.0;
+            }
+
+            sincos(arg, sinArg, cosArg);
+
+            const auto& c = series.cosCoefficients[j];
+            const auto& s = series.sinCoefficients[j];
+
+            for (std::size_t l{}; l < lanes; ++l) {
+                const double C = c[0] + tm[l] * (c[1] + tm[l] * c[2]);
+                const double S = s[0] + tm[l] * (s[1] + tm[l] * s[2]);
+
+                if constexpr (trig == Trig::Sin)
+                    values[l] += active[l] * (C * sinArg[l] + S * cosArg[l]);
+                else
+                    values[l] += active[l] * (C * cosArg[l] - S * sinArg[l]);
+            }
+
+            if (rates.empty()) continue;
+
+            for (std::size_t l{}; l < lanes; ++l) {
+                const double C  = c[0] + tm[l] * (c[1] + tm[l] * c[2]);
+                const double S  = s[0] + tm[l] * (s[1] + tm[l] * s[2]);
+                const double dC = c[1] + 2 * tm[l] * c[2];
+                const double dS = s[1] + 2 * tm[l] * s[2];
+
+                // 每千年 -> 每儒略世纪
+                if constexpr (trig == Trig::Sin)
+                    rates[l] += active[l] * (dC * sinArg[l] + dS * cosArg[l] + omega[l] * (C * cosArg[l] - S * sinArg[l])) / 10;
+                else
+                    rates[l] += active[l] * (dC * cosArg[l] - dS * sinArg[l] - omega[l] * (C * sinArg[l] + S * cosArg[l])) / 10;
+            }
+        }
+    }
+
+    template void calcSeries<Trig::Sin>(std::span<const double> t, const CompiledSeries& series, std::span<double> values, std::span<double> rates, double tolerance);
+
+    template void calcSeries<Trig::Cos>(std::span<const double> t, const CompiledSeries& series, std::span<double> values, std::span<double> rates, double tolerance);
+
+    template<typename Real>
+    Real calcGeocentricDistance(double t, const CompiledSeries& series, const double tolerance, const Summation summation, const Parallelism& parallelism) {
+        return calcSeries<Trig::Cos, Real>(t, series, tolerance, summation, parallelism);
+    }
+
+    template<typename Real>
+    Real calcTrueLongitude(double t, const CompiledSeries& series, const double tolerance, const Summation summation, const Parallelism& parallelism) {
+        return meanLongitude(t / 10) + calcSeries<Trig::Sin, Real>(t, series, tolerance, summation, parallelism) / 3600;
+    }
+
+    template<typename Real>
+    Real calcTrueLatitude(double t, const CompiledSeries& series, const double tolerance, const Summation summation, const Parallelism& parallelism) {
+        return calcSeries<Trig::Sin, Real>(t, series, tolerance, summation, parallelism) / 3600;
+    }
+
+    template long double calcGeocentricDistance<long double>(double t, const CompiledSeries& series, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    template double calcGeocentricDistance<double>(double t, const CompiledSeries& series, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    template long double calcTrueLongitude<long double>(double t, const CompiledSeries& series, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    template double calcTrueLongitude<double>(double t, const CompiledSeries& series, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    template long double calcTrueLatitude<long double>(double t, const CompiledSeries& series, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    template double calcTrueLatitude<double>(double t, const CompiledSeries& series, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    double calcTrueLongitudeRate(double t, const CompiledSeries& series, const double tolerance) { return meanLongitudeRate(t / 10) / 10 + calcSeriesRate<Trig::Sin>(t, series, tolerance) / 3600; }
+
+    template<typename Real>
+    GeoCoord<Real, Real, Real> lea406(
+        double tdb_jd_C,
+        const CompiledSeries& rSeries,
+        const CompiledSeries& vSeries,
+        const CompiledSeries& uSeries,
+        const double tolerance,
+        const Summation summation,
+        const Parallelism& parallelism
+    ) {
+        // 容差以角秒给出，距离按平均地月距离折算为同等角度的弧长
+        const auto distanceTolerance = tolerance * MEAN_DISTANCE * std::numbers::pi / 648000;
+
+        return {
+            calcGeocentricDistance<Real>(tdb_jd_C, rSeries, distanceTolerance, summation, parallelism),
+            calcTrueLongitude<Real>(tdb_jd_C, vSeries, tolerance, summation, parallelism),
+            calcTrueLatitude<Real>(tdb_jd_C, uSeries, tolerance, summation, parallelism)
+        };
+    }
+
+    template GeoCoord<long double, long double, long double> lea406<long double>(
+        double tdb_jd_C, const CompiledSeries& rSeries, const CompiledSeries& vSeries, const CompiledSeries& uSeries, double tolerance, Summation summation, const Parallelism& parallelism
+    );
+
+    template GeoCoord<double, double, double> lea406<double>(
+        double tdb_jd_C, const CompiledSeries& rSeries, const CompiledSeries& vSeries, const CompiledSeries& uSeries, double tolerance, Summation summation, const Parallelism& parallelism
+    );
+
+    constexpr std::size_t PARALLEL_CHUNK = 1024;
+
+    constexpr double RECURRENCE_SPAN = 2e-3;
+
+    constexpr std::size_t PARALLEL_THRESHOLD = 4096;
+
+    CompiledModel compile(const reader::Data& rData, const reader::Data& vData, const reader::Data& uData, const Model model) {
+        return {model, compile(rData), compile(vData), compile(uData)};
+    }
+
+    template<typename Policy, typename Real>
+        requires validationPolicy<Policy>
+    GeoCoord<Real, Real, Real> lea406(double tdb_jd_C, const CompiledModel& model, const double tolerance, const Summation summation, const Parallelism& parallelism) {
+        // 有效时间范围(儒略世纪): 406a为JD 2268932.5~2634166.5，406b为JD 625673.5~2816787.5
+        if constexpr (Policy::enabled) {
+            const auto [first, last] = model.model == Model::Complete ? std::pair{-5.0, 5.0} : std::pair{-50.0, 10.0};
+
+            if (tdb_jd_C < first || tdb_jd_C > last) throw std::invalid_argument(std::format("The time {} exceeds the supported range of the selected LEA-406 series.", tdb_jd_C));
+        }
+
+        return lea406<Real>(tdb_jd_C, model.rSeries, model.vSeries, model.uSeries, tolerance, summation, parallelism);
+    }
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    void lea406(double tdb_jd_C, double step, const CompiledModel& model, std::span<GeoCoord<long double, long double, long double>> coordinates, const double tolerance) {
+        if (coordinates.empty()) return;
+
+        if constexpr (Policy::enabled) {
+            const auto [first, last] = model.model == Model::Complete ? std::pair{-5.0, 5.0} : std::pair{-50.0, 10.0};
+            const auto end           = tdb_jd_C + (coordinates.size() - 1) * step;
+
+            if (std::min(tdb_jd_C, end) < first || std::max(tdb_jd_C, end) > last)
+                throw std::invalid_argument(std::format("The time span [{}, {}] exceeds the supported range of the selected LEA-406 series.", tdb_jd_C, end));
+        }
+
+        const auto distanceTolerance = tolerance * MEAN_DISTANCE * std::numbers::pi / 648000;
+
+        std::vector<double> r(coordinates.size()), v(coordinates.size()), u(coordinates.size());
+
+        calcSeries<Trig::Cos>(tdb_jd_C, step, model.rSeries, r, distanceTolerance);
+        calcSeries<Trig::Sin>(tdb_jd_C, step, model.vSeries, v, tolerance);
+        calcSeries<Trig::Sin>(tdb_jd_C, step, model.uSeries, u, tolerance);
+
+        for (std::size_t k{}; k < coordinates.size(); ++k) {
+            const auto t = tdb_jd_C + k * step;
+
+            coordinates[k] = {r[k], meanLongitude(t / 10) + static_cast<long double>(v[k]) / 3600, static_cast<long double>(u[k]) / 3600};
+        }
+    }
+
+    template GeoCoord<long double, long double, long double>
+    lea406<validation::Checked, long double>(double tdb_jd_C, const CompiledModel& model, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    template GeoCoord<double, double, double>
+    lea406<validation::Checked, double>(double tdb_jd_C, const CompiledModel& model, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    template GeoCoord<long double, long double, long double>
+    lea406<validation::DebugOnly, long double>(double tdb_jd_C, const CompiledModel& model, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    template GeoCoord<double, double, double>
+    lea406<validation::DebugOnly, double>(double tdb_jd_C, const CompiledModel& model, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    template GeoCoord<long double, long double, long double>
+    lea406<validation::Unchecked, long double>(double tdb_jd_C, const CompiledModel& model, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    template GeoCoord<double, double, double>
+    lea406<validation::Unchecked, double>(double tdb_jd_C, const CompiledModel& model, double tolerance, Summation summation, const Parallelism& parallelism);
+
+    template void lea406<validation::Checked>(double tdb_jd_C, double step, const CompiledModel& model, std::span<GeoCoord<long double, long double, long double>> coordinates, double tolerance);
+
+    template void lea406<validation::DebugOnly>(double tdb_jd_C, double step, const CompiledModel& model, std::span<GeoCoord<long double, long double, long double>> coordinates, double tolerance);
+
+    template void lea406<validation::Unchecked>(double tdb_jd_C, double step, const CompiledModel& model, std::span<GeoCoord<long double, long double, long double>> coordinates, double tolerance);
+
 }  // namespace astro::lea
@@ -19,10 +19,17 @@
 
 #include "src/ast.h"
 #include "constant.h"
+#include "pool.h"
+#include "utils.h"
+#include <array>
+#include <cstdint>
 #include <functional>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 namespace astro::lea {
+    // 以下各幅角函数的时间参数为自J2000起算的儒略千年数，结果以度为单位
     double meanLongitude(double t);
 
     double ascendingNodeLongitude(double t);
@@ -55,9 +62,23 @@ namespace astro::lea {
 
     extern const std::vector<std::function<double(double)>> COEFFICIENTS_TABLE;
 
+    extern const std::array<std::array<double, 5>, 14> ARGUMENT_POLYNOMIALS;
+
+    ///< 各基本幅角在t时刻的周数，约化到[0, 1)
+    std::array<double, 14> fundamentalRevolutions(double t);
+
+    ///< 各基本幅角(弧度)，落在[0, 2π)
+    std::array<double, 14> fundamentalArguments(double t);
+
+    ///< 各基本幅角在t时刻的变化率(周/千年)
+    std::array<double, 14> fundamentalRates(double t);
+
+    ///< 平黄经的变化率(度/千年)
+    double meanLongitudeRate(double t);
+
     long double calcOmega(double t, const std::vector<std::shared_ptr<reader::Literal>>& data);
 
-    long double calcSeries(double t, const std::shared_ptr<Term>& term, const std::function<long double(long double)>& tragFunc);
+    long double calcSeries(double t, const std::shared_ptr<reader::Term>& term, const std::function<long double(long double)>& tragFunc);
 
     long double calcGeocentricDistance(double t, const reader::Data& data);
 
@@ -67,6 +88,123 @@ namespace astro::lea {
 
     GeoCoord<long double, long double, long double> lea406(double tdb_jd_C, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData);
 
+    struct CompiledSeries {
+        ///< 14个基本幅角的整数乘数，顺序同COEFFICIENTS_TABLE
+        std::vector<std::array<std::int8_t, 14>> multipliers;
+        ///< 相位折入振幅后的系数 A_i·cos(φ_i)，i为泊松项阶数，配合千年数t使用
+        std::vector<std::array<double, 3>> cosCoefficients;
+        ///< A_i·sin(φ_i)
+        std::vector<std::array<double, 3>> sinCoefficients;
+
+        ///< tailAmplitude[i]为第i项及其后所有项各阶振幅绝对值之和，末尾多一个全0项
+        std::vector<std::array<double, 3>> tailAmplitude;
+    };
+
+    ///< 平均地心距离(km)
+    extern const double MEAN_DISTANCE;
+
+    CompiledSeries compile(const reader::Data& data);
+
+    std::size_t truncation(const CompiledSeries& series, double t, double tolerance);
+
+    enum class Trig { Sin, Cos };
+
+    ///< 并行求值时每块的项数，分块与线程数无关，各块部分和按块序合并，结果与线程数无关
+    extern const std::size_t PARALLEL_CHUNK;
+
+    ///< 截断后项数达到该值才使用线程池，LEA-406b各表均低于该值
+    extern const std::size_t PARALLEL_THRESHOLD;
+
+    struct Parallelism {
+        ///< 为空时单线程求值
+        ThreadPool* pool = nullptr;
+        std::size_t threshold = PARALLEL_THRESHOLD;
+    };
+
+    /**
+     * @brief 级数在t时刻的值，Real为返回类型
+     * @details Neumaier与Blocked累加全程为double，不经过long double；Real为long double时只在返回时转换。
+     *          Summation::LongDouble以long double累加，只能配合Real = long double
+     * @throw std::invalid_argument Real为double而summation为LongDouble
+     * */
+    template<Trig trig, typename Real = long double>
+    Real calcSeries(double t, const CompiledSeries& series, double tolerance = 0, Summation summation = std::is_same_v<Real, double> ? Summation::Neumaier : Summation::LongDouble, const Parallelism& parallelism = {});
+
+    /**
+     * @brief 等步长时间序列t0 + k·step (k = 0..N-1)上的级数值，N为输出长度
+     * @details 基本幅角为t的四次多项式，锚定间隔内按二阶差分递推各项幅角，三次以上差分的影响可以忽略
+     * @throw std::invalid_argument step为0或非有限值
+     * */
+    template<Trig trig>
+    void calcSeries(double t0, double step, const CompiledSeries& series, std::span<double> values, double tolerance = 0);
+
+    ///< 两次锚定之间允许跨越的最长时间(千年)，超过后幅角的三阶差分不可忽略，步长较大时锚定间隔相应缩短
+    extern const double RECURRENCE_SPAN;
+
+    /**
+     * @brief 级数对时间的导数(单位/儒略世纪)
+     * @details 逐项求导 d/dt[C(t)·sin(arg) + S(t)·cos(arg)] = C'·sin + S'·cos + arg'·(C·cos - S·sin)
+     * */
+    template<Trig trig>
+    double calcSeriesRate(double t, const CompiledSeries& series, double tolerance = 0);
+
+    /**
+     * @brief 多个任意历元上的级数值，逐项对所有历元求值，各项系数只读取一次，历元方向的循环可被向量化
+     * @details 每个历元按自身的|t|截断，取的项与单历元求值相同，但以double逐项累加，与单历元的结果只在舍入误差上不同；
+     *          rates非空时同时给出对时间的导数(单位/儒略世纪)，与级数值共用各项的正余弦
+     * @throw std::invalid_argument 输出区间与历元数不一致
+     * */
+    template<Trig trig>
+    void calcSeries(std::span<const double> t, const CompiledSeries& series, std::span<double> values, std::span<double> rates = {}, double tolerance = 0);
+
+    template<typename Real = long double>
+    Real calcGeocentricDistance(double t, const CompiledSeries& series, double tolerance = 0, Summation summation = std::is_same_v<Real, double> ? Summation::Neumaier : Summation::LongDouble, const Parallelism& parallelism = {});
+
+    template<typename Real = long double>
+    Real calcTrueLongitude(double t, const CompiledSeries& series, double tolerance = 0, Summation summation = std::is_same_v<Real, double> ? Summation::Neumaier : Summation::LongDouble, const Parallelism& parallelism = {});
+
+    template<typename Real = long double>
+    Real calcTrueLatitude(double t, const CompiledSeries& series, double tolerance = 0, Summation summation = std::is_same_v<Real, double> ? Summation::Neumaier : Summation::LongDouble, const Parallelism& parallelism = {});
+
+    ///< 真黄经的变化率(度/儒略世纪)
+    double calcTrueLongitudeRate(double t, const CompiledSeries& series, double tolerance = 0);
+
+    ///< Real = double时三个分量均为纯double求值，默认Neumaier累加
+    template<typename Real = long double>
+    GeoCoord<Real, Real, Real> lea406(
+        double tdb_jd_C,
+        const CompiledSeries& rSeries,
+        const CompiledSeries& vSeries,
+        const CompiledSeries& uSeries,
+        double tolerance                = 0,
+        Summation summation             = std::is_same_v<Real, double> ? Summation::Neumaier : Summation::LongDouble,
+        const Parallelism& parallelism = {}
+    );
+
+    enum class Model {
+        ///< LEA-406a完整级数(table6~8)，1500~2500年，约1cm
+        Complete,
+        ///< LEA-406b简化级数(table9~11)，公元前3000~公元3000年，约1m
+        Simplified
+    };
+
+    struct CompiledModel {
+        Model model;
+        CompiledSeries rSeries;
+        CompiledSeries vSeries;
+        CompiledSeries uSeries;
+    };
+
+    CompiledModel compile(const reader::Data& rData, const reader::Data& vData, const reader::Data& uData, Model model);
+
+    template<typename Policy = DefaultValidation, typename Real = long double>
+        requires validationPolicy<Policy>
+    GeoCoord<Real, Real, Real> lea406(double tdb_jd_C, const CompiledModel& model, double tolerance = 0, Summation summation = std::is_same_v<Real, double> ? Summation::Neumaier : Summation::LongDouble, const Parallelism& parallelism = {});
+
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    void lea406(double tdb_jd_C, double step, const CompiledModel& model, std::span<GeoCoord<long double, long double, long double>> coordinates, double tolerance = 0);
+
 }  // namespace astro::lea
 
 
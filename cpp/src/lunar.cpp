@@ -0,0 +1,449 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file lunar.cpp
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/09/06 15:20
+ * @brief
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#include "lunar.h"
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <functional>
+#include <stdexcept>
+
+namespace astro {
+    constexpr double LUNAR_TIME_ZONE = 8.0;
+
+    constexpr std::size_t LUNAR_CACHE_CAPACITY = 64;
+
+    constexpr std::size_t LUNAR_BATCH_CHUNK = 4096;
+
+    namespace {
+        // pool为空时在调用线程上顺序执行
+        void forEach(ThreadPool* pool, const std::size_t count, const std::function<void(std::size_t)>& body) {
+            if (pool) return pool->parallelFor(count, body);
+
+            for (std::size_t i{}; i < count; ++i) body(i);
+        }
+    }  // namespace
+
+    int dayNumber(const DateTime& date) {
+        // 正午的儒略日恰为整数
+        return static_cast<int>(std::lround(DateTime{date.year, date.month, date.day, 12, 0, 0, date.scale}.toJulianDay().value));
+    }
+
+    int civilDayNumber(const double tdb_jd_C) {
+        const auto utc = JulianDay{J2000.to(TDB).value + tdb_jd_C * 36525, TDB}.to(UTC).value;
+
+        return static_cast<int>(std::floor(utc + 0.5 + LUNAR_TIME_ZONE / 24));
+    }
+
+    double civilDayStart(const int dayNumber) { return julianCentury(JulianDay{dayNumber - 0.5 - LUNAR_TIME_ZONE / 24, UTC}, TDB); }
+
+    bool LunarYearTable::contains(const int dayNumber) const noexcept { return !months.empty() && months.front().start <= dayNumber && dayNumber < end; }
+
+    std::size_t LunarYearTable::monthIndex(const int dayNumber) const {
+        if (!contains(dayNumber)) throw std::out_of_range(std::format("The day {} is outside the lunar year {}.", dayNumber, year));
+
+        // 最后一个月首不晚于该日的月份
+        const auto next = std::upper_bound(months.begin(), months.end(), dayNumber, [](int day, const LunarMonth& month) { return day < month.start; });
+
+        return next - months.begin() - 1;
+    }
+
+    LunarDate LunarYearTable::toLunar(const DateTime& gregorianDate) const { return toLunar(dayNumber(gregorianDate), gregorianDate.hour, gregorianDate.minute, gregorianDate.second); }
+
+    LunarDate LunarYearTable::toLunar(const int dayNumber, const int hour, const int minute, const double second) const {
+        const auto& month = months[monthIndex(dayNumber)];
+
+        return {year, month.number, dayNumber - month.start + 1, hour, minute, second, month.isLeap};
+    }
+
+    std::vector<LunarMonth> lunarSui(const std::span<const double> newMoons, const std::span<const double> zhongqi) {
+        if (zhongqi.size() != 12 || newMoons.size() < 13)
+            throw std::invalid_argument(std::format("lunarSui: expected 12 zhongqi and at least 13 new moons, got {} and {}", zhongqi.size(), newMoons.size()));
+
+        const auto count = newMoons.size() - 1;
+
+        std::vector<LunarMonth> months(count);
+
+        for (std::size_t i{}, j{}; i < count; ++i) {
+            const auto start = civilDayNumber(newMoons[i]);
+            const auto end   = civilDayNumber(newMoons[i + 1]);
+
+            months[i] = {start, newMoons[i], 0, false, std::nullopt};
+
+            while (j < zhongqi.size() && civilDayNumber(zhongqi[j]) < start) ++j;
+
+            if (j < zhongqi.size() && civilDayNumber(zhongqi[j]) < end) months[i].zhongqi = TERM_TABLE[(21 + 2 * j) % 24];
+        }
+
+        // 13个月时冬至所在月之后第一个无中气的月置闰，闰月不占月序
+        const auto leap = count > 12 ? std::find_if(months.begin() + 1, months.end(), [](const LunarMonth& month) { return !month.zhongqi; }) : months.end();
+        if (leap != months.end()) leap->isLeap = true;
+
+        int number = 11;
+        for (std::size_t i{}; i < count; ++i) {
+            if (i && !months[i].isLeap) number = number % 12 + 1;
+
+            months[i].number = number;
+        }
+
+        return months;
+    }
+
+    LunarYearTable lunarYearTable(const int year, const std::span<const LunarMonth> prev, const std::span<const LunarMonth> next) {
+        // 正月在前一岁中，次年正月在后一岁中，两者都在冬至所在月之后的第2或第3个月
+        const auto isFirst = [](const LunarMonth& month) { return month.number == 1 && !month.isLeap; };
+
+        const auto begin = std::find_if(prev.begin(), prev.end(), isFirst);
+        const auto end   = std::find_if(next.begin(), next.end(), isFirst);
+
+        if (begin == prev.end() || end == next.end()) throw std::runtime_error(std::format("lunarYearTable: no first month found around the year {}", year));
+
+        LunarYearTable table{year, {begin, prev.end()}, end->start};
+        table.months.insert(table.months.end(), next.begin(), end);
+
+        return table;
+    }
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    LunarYearTable lunarYearTable(int year, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries) {
+        return lunarYearTable(
+            year, [&](double t) { return moonSunElongation<Policy>(t, data, rSeries, vSeries, uSeries); }, [&](double t) { return solarLongitude<Policy>(t, data); }
+        );
+    }
+
+    template LunarYearTable
+    lunarYearTable<validation::Checked>(int year, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries);
+
+    template LunarYearTable
+    lunarYearTable<validation::DebugOnly>(int year, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries);
+
+    template LunarYearTable
+    lunarYearTable<validation::Unchecked>(int year, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries);
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    void sweepLunarCalendar(
+        const DateTime& first,
+        const DateTime& last,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        const std::span<LunarDate> lunarDates
+    ) {
+        const auto firstDay = dayNumber(first);
+        const auto days     = std::max(dayNumber(last) - firstDay + 1, 0);
+
+        if (lunarDates.size() != static_cast<std::size_t>(days)) throw std::invalid_argument(std::format("sweepLunarCalendar: {} days but {} output slots", days, lunarDates.size()));
+
+        sweepLunarCalendar(
+            first,
+            last,
+            [&](double t) { return moonSunElongation<Policy>(t, data, rSeries, vSeries, uSeries); },
+            [&](double t) { return solarLongitude<Policy>(t, data); },
+            [&](const int day, const LunarDate& lunarDate) { lunarDates[day - firstDay] = lunarDate; }
+        );
+    }
+
+    template void sweepLunarCalendar<validation::Checked>(
+        const DateTime& first,
+        const DateTime& last,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        std::span<LunarDate> lunarDates
+    );
+
+    template void sweepLunarCalendar<validation::DebugOnly>(
+        const DateTime& first,
+        const DateTime& last,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        std::span<LunarDate> lunarDates
+    );
+
+    template void sweepLunarCalendar<validation::Unchecked>(
+        const DateTime& first,
+        const DateTime& last,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        std::span<LunarDate> lunarDates
+    );
+
+    LunarYearCache::LunarYearCache(const std::size_t capacity) : limit(capacity) {
+        if (!capacity) throw std::invalid_argument("LunarYearCache: capacity must be positive");
+    }
+
+    std::shared_ptr<const LunarYearTable> LunarYearCache::find(const int year) {
+        std::lock_guard lock(mutex);
+
+        const auto it = index.find(year);
+
+        if (it == index.end()) {
+            ++counters.misses;
+            return nullptr;
+        }
+
+        ++counters.hits;
+        entries.splice(entries.begin(), entries, it->second);
+
+        return *it->second;
+    }
+
+    std::shared_ptr<const LunarYearTable> LunarYearCache::insert(std::shared_ptr<const LunarYearTable> table) {
+        std::lock_guard lock(mutex);
+
+        if (const auto it = index.find(table->year); it != index.end()) {
+            entries.splice(entries.begin(), entries, it->second);
+            return *it->second;
+        }
+
+        if (entries.size() == limit) {
+            index.erase(entries.back()->year);
+            entries.pop_back();
+            ++counters.evictions;
+        }
+
+        entries.push_front(std::move(table));
+        index.emplace(entries.front()->year, entries.begin());
+
+        return entries.front();
+    }
+
+    CacheStatistics LunarYearCache::statistics() const {
+        std::lock_guard lock(mutex);
+
+        return counters;
+    }
+
+    std::size_t LunarYearCache::capacity() const noexcept { return limit; }
+
+    std::size_t LunarYearCache::size() const {
+        std::lock_guard lock(mutex);
+
+        return entries.size();
+    }
+
+    void LunarYearCache::clear() {
+        std::lock_guard lock(mutex);
+
+        entries.clear();
+        index.clear();
+        counters = {};
+    }
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    LunarDate gregorianToLunar(
+        const DateTime& gregorianDate,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        LunarYearCache& cache
+    ) {
+        const auto build = [&](int year) { return lunarYearTable<Policy>(year, data, rSeries, vSeries, uSeries); };
+
+        auto table = cache.get(gregorianDate.year, build);
+
+        if (dayNumber(gregorianDate) < table->months.front().start) table = cache.get(gregorianDate.year - 1, build);
+
+        return table->toLunar(gregorianDate);
+    }
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    void gregorianToLunar(
+        const std::span<const DateTime> gregorianDates,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        LunarYearCache& cache,
+        const std::span<LunarDate> lunarDates,
+        ThreadPool* pool
+    ) {
+        if (gregorianDates.size() != lunarDates.size())
+            throw std::invalid_argument(std::format("gregorianToLunar: {} dates but {} output slots", gregorianDates.size(), lunarDates.size()));
+
+        if (gregorianDates.empty()) return;
+
+        const auto [earliest, latest] = std::ranges::minmax(gregorianDates, {}, &DateTime::year);
+
+        // 下标为农历年 - first，表在本次换算期间由shared_ptr持有，不受缓存淘汰影响
+        const auto first = earliest.year - 1;
+
+        std::vector<std::shared_ptr<const LunarYearTable>> tables(latest.year - first + 1);
+        std::vector<char> needed(tables.size());
+        std::vector<int> days(gregorianDates.size());
+
+        for (std::size_t i{}; i < gregorianDates.size(); ++i) {
+            const auto& date    = gregorianDates[i];
+            const auto monthDay = date.month * 100 + date.day;
+
+            days[i] = dayNumber(date);
+
+            if (monthDay <= 220) needed[date.year - 1 - first] = true;
+            if (monthDay >= 121) needed[date.year - first] = true;
+        }
+
+        std::vector<int> years;
+        for (std::size_t k{}; k < needed.size(); ++k)
+            if (needed[k]) years.push_back(first + static_cast<int>(k));
+
+        const auto build = [&](int year) { return lunarYearTable<Policy>(year, data, rSeries, vSeries, uSeries); };
+
+        forEach(pool, years.size(), [&](const std::size_t k) { tables[years[k] - first] = cache.get(years[k], build); });
+
+        const auto chunks = (gregorianDates.size() + LUNAR_BATCH_CHUNK - 1) / LUNAR_BATCH_CHUNK;
+
+        forEach(pool, chunks, [&](const std::size_t chunk) {
+            for (std::size_t i = chunk * LUNAR_BATCH_CHUNK; i < std::min(gregorianDates.size(), (chunk + 1) * LUNAR_BATCH_CHUNK); ++i) {
+                const auto& date = gregorianDates[i];
+
+                auto table = tables[date.year - first].get();
+                if (!table || !table->contains(days[i])) table = tables[date.year - 1 - first].get();
+
+                lunarDates[i] = table->toLunar(days[i], date.hour, date.minute, date.second);
+            }
+        });
+    }
+
+    template void gregorianToLunar<validation::Checked>(
+        std::span<const DateTime> gregorianDates,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        LunarYearCache& cache,
+        std::span<LunarDate> lunarDates,
+        ThreadPool* pool
+    );
+
+    template void gregorianToLunar<validation::DebugOnly>(
+        std::span<const DateTime> gregorianDates,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        LunarYearCache& cache,
+        std::span<LunarDate> lunarDates,
+        ThreadPool* pool
+    );
+
+    template void gregorianToLunar<validation::Unchecked>(
+        std::span<const DateTime> gregorianDates,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        LunarYearCache& cache,
+        std::span<LunarDate> lunarDates,
+        ThreadPool* pool
+    );
+
+    template LunarDate gregorianToLunar<validation::Checked>(
+        const DateTime& gregorianDate,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        LunarYearCache& cache
+    );
+
+    template LunarDate gregorianToLunar<validation::DebugOnly>(
+        const DateTime& gregorianDate,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        LunarYearCache& cache
+    );
+
+    template LunarDate gregorianToLunar<validation::Unchecked>(
+        const DateTime& gregorianDate,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        LunarYearCache& cache
+    );
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    std::vector<LunarYearTable> precomputeLunarYears(
+        const int firstYear,
+        const int lastYear,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        ThreadPool& pool,
+        const LunarProgress& progress,
+        std::stop_token stop
+    ) {
+        return precomputeLunarYears(
+            firstYear,
+            lastYear,
+            [&](double t) { return moonSunElongation<Policy>(t, data, rSeries, vSeries, uSeries); },
+            [&](double t) { return solarLongitude<Policy>(t, data); },
+            pool,
+            progress,
+            std::move(stop)
+        );
+    }
+
+    template std::vector<LunarYearTable> precomputeLunarYears<validation::Checked>(
+        int firstYear,
+        int lastYear,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        ThreadPool& pool,
+        const LunarProgress& progress,
+        std::stop_token stop
+    );
+
+    template std::vector<LunarYearTable> precomputeLunarYears<validation::DebugOnly>(
+        int firstYear,
+        int lastYear,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        ThreadPool& pool,
+        const LunarProgress& progress,
+        std::stop_token stop
+    );
+
+    template std::vector<LunarYearTable> precomputeLunarYears<validation::Unchecked>(
+        int firstYear,
+        int lastYear,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        ThreadPool& pool,
+        const LunarProgress& progress,
+        std::stop_token stop
+    );
+}  // namespace astro
@@ -0,0 +1,255 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file lunar.h
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/09/06 15:20
+ * @brief
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#ifndef LUNAR_H
+#define LUNAR_H
+#pragma once
+
+#include "cache.h"
+#include "calender.h"
+#include "constant.h"
+#include "pool.h"
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <unordered_map>
+#include <vector>
+
+namespace astro {
+    ///< 农历按北京时间划分日期，时区偏移(小时)
+    extern const double LUNAR_TIME_ZONE;
+
+    ///< 公历日期(按北京时间的民用日理解)的儒略日数，时分秒与时间尺度不影响结果
+    int dayNumber(const DateTime& date);
+
+    ///< tdb_jd_C时刻在北京时间下所在民用日的儒略日数
+    int civilDayNumber(double tdb_jd_C);
+
+    ///< 儒略日数为dayNumber的民用日在北京时间0时的时刻(儒略世纪，TDB)
+    double civilDayStart(int dayNumber);
+
+    struct LunarMonth {
+        ///< 月首(朔日)的儒略日数
+        int start;
+        ///< 合朔时刻(儒略世纪，TDB)
+        double newMoon;
+        ///< 月序，1为正月
+        int number;
+        bool isLeap;
+        ///< 月内的中气，无中气的月份为空
+        std::optional<Term> zhongqi;
+    };
+
+    struct LunarYearTable {
+        ///< 正月所在的公历年
+        int year;
+        ///< 正月起的各月，12或13个
+        std::vector<LunarMonth> months;
+        ///< 次年正月月首的儒略日数，表覆盖[months.front().start, end)
+        int end;
+
+        [[nodiscard]] bool contains(int dayNumber) const noexcept;
+
+        ///< 儒略日数为dayNumber的一天在表中的月份下标，二分查找
+        [[nodiscard]] std::size_t monthIndex(int dayNumber) const;
+
+        /**
+         * @brief 查表得到公历日期对应的农历日期，时分秒原样保留
+         * @throw std::out_of_range 日期不在该农历年内
+         * */
+        [[nodiscard]] LunarDate toLunar(const DateTime& gregorianDate) const;
+
+        ///< 已知儒略日数时直接查表，时分秒原样保留
+        [[nodiscard]] LunarDate toLunar(int dayNumber, int hour, int minute, double second) const;
+    };
+
+    /**
+     * @brief 由冬至所在月起，到下一个冬至所在月之前的各月(一岁)
+     * @details newMoons为两冬至所在月的月首之间(含两端)的各次合朔，zhongqi为冬至起的12个中气的时刻。
+     *          两冬至间有13个朔望月时，冬至所在月之后第一个不含中气的月为闰月，沿用上一月的月序
+     * @throw std::invalid_argument 中气不是12个或合朔少于13次
+     * */
+    std::vector<LunarMonth> lunarSui(std::span<const double> newMoons, std::span<const double> zhongqi);
+
+    template<typename ElongationFunc, typename SolarFunc>
+        requires elongationCalcFunc<ElongationFunc> && solarLongitudeCalcFunc<SolarFunc>
+    std::vector<LunarMonth> lunarSui(double winterSolstice, double nextWinterSolstice, const ElongationFunc& elongation, const SolarFunc& solarLong);
+
+    ///< 公历year年的冬至时刻(儒略世纪，TDB)
+    template<typename SolarFunc>
+        requires solarLongitudeCalcFunc<SolarFunc>
+    double winterSolstice(int year, const SolarFunc& solarLong);
+
+    /**
+     * @brief 由前后两岁拼接农历年year(正月所在公历年)的月表，prev为year - 1年冬至起的一岁，next为year年冬至起的一岁
+     * @throw std::runtime_error 两岁中找不到正月
+     * */
+    LunarYearTable lunarYearTable(int year, std::span<const LunarMonth> prev, std::span<const LunarMonth> next);
+
+    ///< 农历年year(正月所在公历年)的月表，由前后两岁拼接
+    template<typename ElongationFunc, typename SolarFunc>
+        requires elongationCalcFunc<ElongationFunc> && solarLongitudeCalcFunc<SolarFunc>
+    LunarYearTable lunarYearTable(int year, const ElongationFunc& elongation, const SolarFunc& solarLong);
+
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    LunarYearTable lunarYearTable(int year, const vsop::CompiledData& data, const lea::CompiledSeries& rSeries, const lea::CompiledSeries& vSeries, const lea::CompiledSeries& uSeries);
+
+    ///< 农历年表缓存的默认容量(年)
+    extern const std::size_t LUNAR_CACHE_CAPACITY;
+
+    /**
+     * @brief 以农历年为键的LRU缓存，容量有界
+     * @details 表以shared_ptr共享，被淘汰后已取出的表仍然有效；查找与插入在同一把锁内完成，建表在锁外进行
+     * @note 同一年可能被多个线程同时建表，结果相同，只保留先写入的一份
+     * */
+    class LunarYearCache {
+    public:
+        explicit LunarYearCache(std::size_t capacity = LUNAR_CACHE_CAPACITY);
+
+        LunarYearCache(const LunarYearCache&) = delete;
+
+        LunarYearCache& operator=(const LunarYearCache&) = delete;
+
+        [[nodiscard]] std::shared_ptr<const LunarYearTable> find(int year);
+
+        ///< 返回缓存中该年的表，已存在时丢弃table
+        std::shared_ptr<const LunarYearTable> insert(std::shared_ptr<const LunarYearTable> table);
+
+        ///< 命中则返回缓存的表，否则调用build(year)建表并写入
+        template<typename Func>
+        std::shared_ptr<const LunarYearTable> get(int year, const Func& build);
+
+        [[nodiscard]] CacheStatistics statistics() const;
+
+        [[nodiscard]] std::size_t capacity() const noexcept;
+
+        [[nodiscard]] std::size_t size() const;
+
+        void clear();
+
+    private:
+        std::size_t limit;
+
+        ///< 头部为最近使用
+        std::list<std::shared_ptr<const LunarYearTable>> entries;
+        std::unordered_map<int, std::list<std::shared_ptr<const LunarYearTable>>::iterator> index;
+
+        CacheStatistics counters;
+
+        mutable std::mutex mutex;
+    };
+
+    /**
+     * @brief 查表的公历转农历，所在农历年不在缓存中时先建表
+     * @details 公历年的正月之前属于上一农历年，最多查两张表
+     * */
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    LunarDate gregorianToLunar(
+        const DateTime& gregorianDate,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        LunarYearCache& cache
+    );
+
+    template<typename Sink>
+    concept lunarDaySink = requires(Sink sink, int dayNumber, const LunarDate& lunarDate) { sink(dayNumber, lunarDate); };
+
+    /**
+     * @brief 按日期顺序给出公历first至last(含)每一天的农历日期，sink(儒略日数, 农历日期)
+     * @details 合朔与中气沿时间顺序各只求一次，每次以上一事件为起点，总代价为O(天数 + 朔望月数)
+     * */
+    template<typename ElongationFunc, typename SolarFunc, typename Sink>
+        requires elongationCalcFunc<ElongationFunc> && solarLongitudeCalcFunc<SolarFunc> && lunarDaySink<Sink>
+    void sweepLunarCalendar(const DateTime& first, const DateTime& last, const ElongationFunc& elongation, const SolarFunc& solarLong, Sink&& sink);
+
+    /**
+     * @brief 公历first至last(含)每一天的农历日期依次写入lunarDates
+     * @throw std::invalid_argument lunarDates的长度与天数不一致
+     * */
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    void sweepLunarCalendar(
+        const DateTime& first,
+        const DateTime& last,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        std::span<LunarDate> lunarDates
+    );
+
+    ///< 批量换算时每个任务处理的日期数
+    extern const std::size_t LUNAR_BATCH_CHUNK;
+
+    /**
+     * @brief 批量公历转农历，输入可以无序，结果按输入顺序写入lunarDates
+     * @details 先求全部日期的儒略日数并收集用到的农历年，每年只经cache建表一次，再逐个二分查表。正月初一总在公历1月21日至2月20日之间，
+     *          其间的日期同时需要当年与上一年的表，此前只需上一年，此后只需当年。pool非空时建表与查表都分派到线程池
+     * @throw std::invalid_argument 输出区间与输入长度不一致
+     * */
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    void gregorianToLunar(
+        std::span<const DateTime> gregorianDates,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        LunarYearCache& cache,
+        std::span<LunarDate> lunarDates,
+        ThreadPool* pool = nullptr
+    );
+
+    ///< 预计算进度回调(已完成年数, 总年数)，调用互相串行且已完成年数递增
+    using LunarProgress = std::function<void(std::size_t, std::size_t)>;
+
+    /**
+     * @brief 在线程池上预计算firstYear至lastYear(含)各农历年的月表，按年份升序返回
+     * @details 各年以pool.stealingFor分派，同一线程多领取到连续的年份，其暂存的后一岁与冬至直接作为下一年的前一岁，
+     *          每年只需再求一岁。结果与逐年调用lunarYearTable相同，与线程数和分派方式无关
+     * @note stop被请求后不再开始新的年份，返回已完成的各年(可能不连续)
+     * */
+    template<typename ElongationFunc, typename SolarFunc>
+        requires elongationCalcFunc<ElongationFunc> && solarLongitudeCalcFunc<SolarFunc>
+    std::vector<LunarYearTable> precomputeLunarYears(
+        int firstYear, int lastYear, const ElongationFunc& elongation, const SolarFunc& solarLong, ThreadPool& pool, const LunarProgress& progress = {}, std::stop_token stop = {}
+    );
+
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    std::vector<LunarYearTable> precomputeLunarYears(
+        int firstYear,
+        int lastYear,
+        const vsop::CompiledData& data,
+        const lea::CompiledSeries& rSeries,
+        const lea::CompiledSeries& vSeries,
+        const lea::CompiledSeries& uSeries,
+        ThreadPool& pool,
+        const LunarProgress& progress = {},
+        std::stop_token stop           = {}
+    );
+}  // namespace astro
+
+#include "lunar.hpp"
+
+#endif  // LUNAR_H
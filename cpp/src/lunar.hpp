@@ -0,0 +1,180 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file lunar.hpp
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/09/06 15:20
+ * @brief
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#ifndef LUNAR_HPP
+#define LUNAR_HPP
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace astro {
+    template<typename ElongationFunc, typename SolarFunc>
+        requires elongationCalcFunc<ElongationFunc> && solarLongitudeCalcFunc<SolarFunc>
+    std::vector<LunarMonth> lunarSui(double winterSolstice, double nextWinterSolstice, const ElongationFunc& elongation, const SolarFunc& solarLong) {
+        // 冬至所在月首: 冬至当日结束前的最后一次合朔
+        const auto first = findPrevNewMoon(civilDayStart(civilDayNumber(winterSolstice) + 1), elongation);
+        const auto last  = findPrevNewMoon(civilDayStart(civilDayNumber(nextWinterSolstice) + 1), elongation);
+
+        const auto count = static_cast<std::size_t>(std::lround((last - first) * 36525 / MEAN_LUNAR_MONTH));
+
+        std::vector<double> newMoons{first};
+        for (std::size_t i = 1; i < count; ++i) newMoons.push_back(findNextNewMoon(newMoons.back(), elongation));
+        newMoons.push_back(last);
+
+        // 冬至起的12个中气，依次为冬至、大寒、雨水……小雪
+        std::array<double, 12> zhongqi{winterSolstice};
+
+        for (std::size_t i = 1; i < zhongqi.size(); ++i) zhongqi[i] = findSolarTermForward(zhongqi[i - 1], TERM_TABLE[(21 + 2 * i) % 24], solarLong);
+
+        return lunarSui(newMoons, zhongqi);
+    }
+
+    template<typename SolarFunc>
+        requires solarLongitudeCalcFunc<SolarFunc>
+    double winterSolstice(int year, const SolarFunc& solarLong) {
+        // 冬至总在12月1日之后
+        return findSolarTermForward(julianCentury(DateTime{year, 12, 1, 0, 0, 0, UTC}.toJulianDay(), TDB), Term::WinterSolstice, solarLong);
+    }
+
+    template<typename ElongationFunc, typename SolarFunc>
+        requires elongationCalcFunc<ElongationFunc> && solarLongitudeCalcFunc<SolarFunc>
+    LunarYearTable lunarYearTable(int year, const ElongationFunc& elongation, const SolarFunc& solarLong) {
+        const auto solstice = winterSolstice(year, solarLong);
+
+        return lunarYearTable(
+            year, lunarSui(winterSolstice(year - 1, solarLong), solstice, elongation, solarLong), lunarSui(solstice, winterSolstice(year + 1, solarLong), elongation, solarLong)
+        );
+    }
+
+    template<typename ElongationFunc, typename SolarFunc, typename Sink>
+        requires elongationCalcFunc<ElongationFunc> && solarLongitudeCalcFunc<SolarFunc> && lunarDaySink<Sink>
+    void sweepLunarCalendar(const DateTime& first, const DateTime& last, const ElongationFunc& elongation, const SolarFunc& solarLong, Sink&& sink) {
+        const auto firstDay = dayNumber(first);
+        const auto lastDay  = dayNumber(last);
+
+        if (firstDay > lastDay) return;
+
+        // first所在公历年的元旦总在上一年冬至之后，从该冬至所在的一岁开始
+        auto year = first.year;
+
+        std::array<double, 12> zhongqi{findSolarTermForward(julianCentury(DateTime{year - 1, 12, 1, 0, 0, 0, UTC}.toJulianDay(), TDB), Term::WinterSolstice, solarLong)};
+
+        std::vector<double> newMoons{findPrevNewMoon(civilDayStart(civilDayNumber(zhongqi[0]) + 1), elongation)};
+
+        while (true) {
+            for (std::size_t i = 1; i < zhongqi.size(); ++i) zhongqi[i] = findSolarTermForward(zhongqi[i - 1], TERM_TABLE[(21 + 2 * i) % 24], solarLong);
+
+            const auto nextWinterSolstice = findSolarTermForward(zhongqi.back(), Term::WinterSolstice, solarLong);
+            const auto boundary           = civilDayNumber(nextWinterSolstice) + 1;
+
+            // 续求合朔直到越过下一个冬至所在日，越过的一次留给下一岁
+            while (civilDayNumber(newMoons.back()) < boundary) newMoons.push_back(findNextNewMoon(newMoons.back(), elongation));
+
+            const auto count = newMoons.size() - 1;
+            const auto sui   = lunarSui(std::span<const double>(newMoons).first(count), zhongqi);
+
+            // 正月之前的十一、十二月(及其闰月)属于上一农历年
+            auto lunarYear = year - 1;
+
+            for (std::size_t i{}; i < sui.size(); ++i) {
+                if (sui[i].number == 1 && !sui[i].isLeap) lunarYear = year;
+
+                const auto end = i + 1 < sui.size() ? sui[i + 1].start : civilDayNumber(newMoons[count - 1]);
+
+                for (auto day = std::max(sui[i].start, firstDay); day < std::min(end, lastDay + 1); ++day)
+                    sink(day, LunarDate{lunarYear, sui[i].number, day - sui[i].start + 1, 0, 0, 0, sui[i].isLeap});
+            }
+
+            newMoons.erase(newMoons.begin(), newMoons.begin() + static_cast<std::ptrdiff_t>(count - 1));
+
+            if (civilDayNumber(newMoons.front()) > lastDay) return;
+
+            zhongqi[0] = nextWinterSolstice;
+            ++year;
+        }
+    }
+
+    template<typename ElongationFunc, typename SolarFunc>
+        requires elongationCalcFunc<ElongationFunc> && solarLongitudeCalcFunc<SolarFunc>
+    std::vector<LunarYearTable> precomputeLunarYears(
+        int firstYear, int lastYear, const ElongationFunc& elongation, const SolarFunc& solarLong, ThreadPool& pool, const LunarProgress& progress, std::stop_token stop
+    ) {
+        if (firstYear > lastYear) return {};
+
+        const auto count = static_cast<std::size_t>(lastYear - firstYear + 1);
+
+        // 每个参与线程上一次完成的年份，及该年冬至起的一岁与次年冬至，独占缓存行
+        struct alignas(64) Scratch {
+            std::optional<int> year;
+            std::vector<LunarMonth> next;
+            double nextSolstice{};
+        };
+
+        std::vector<Scratch> scratches(pool.size() + 1);
+        std::vector<std::optional<LunarYearTable>> tables(count);
+
+        std::size_t finished{};
+        std::mutex progressMutex;
+
+        pool.stealingFor(count, [&](const std::size_t i, const std::size_t participant) {
+            if (stop.stop_requested()) return;
+
+            auto& scratch   = scratches[participant];
+            const auto year = firstYear + static_cast<int>(i);
+
+            std::vector<LunarMonth> prev;
+            double solstice;
+
+            if (scratch.year == year - 1) {
+                prev     = std::move(scratch.next);
+                solstice = scratch.nextSolstice;
+            }
+            else {
+                solstice = winterSolstice(year, solarLong);
+                prev     = lunarSui(winterSolstice(year - 1, solarLong), solstice, elongation, solarLong);
+            }
+
+            const auto nextSolstice = winterSolstice(year + 1, solarLong);
+            auto next               = lunarSui(solstice, nextSolstice, elongation, solarLong);
+
+            tables[i] = lunarYearTable(year, prev, next);
+            scratch   = {year, std::move(next), nextSolstice};
+
+            if (progress) {
+                std::lock_guard lock(progressMutex);
+                progress(++finished, count);
+            }
+        });
+
+        std::vector<LunarYearTable> result;
+        result.reserve(count);
+
+        for (auto& table : tables)
+            if (table) result.push_back(std::move(*table));
+
+        return result;
+    }
+
+    template<typename Func>
+    std::shared_ptr<const LunarYearTable> LunarYearCache::get(int year, const Func& build) {
+        if (auto table = find(year)) return table;
+
+        return insert(std::make_shared<const LunarYearTable>(build(year)));
+    }
+}  // namespace astro
+
+#endif  // LUNAR_HPP
@@ -20,14 +20,17 @@
 #include <ranges>
 
 namespace astro {
+    template<typename Policy>
+        requires validationPolicy<Policy>
     LunarDate gregorianToLunar(const DateTime& gregorianDate, const reader::Data& data, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData) {
         auto jd = gregorianDate.toJulianDay();
 
         auto tdb_jd_C = julianCentury(jd, TDB);
 
-        const auto solarAppCoord = [&](double t) { return solarApparentCoordinate(t, data); };
+        const auto solarAppCoord = [&](double t) { return solarApparentCoordinate<Policy>(t, data); };
 
-        const auto moonAppCoord = [&](double t) { return moonApparentCoordinate(t, data, rData, vData, uData); };
+        // 合朔只依赖月日黄经差，太阳每个历元只求一次
+        const auto elongation = [&](double t) { return moonSunElongation<Policy>(t, data, rData, vData, uData); };
 
         // 一些农历重要时刻
 
@@ -50,13 +53,13 @@ namespace astro {
         const int mouthCount = (rightWinterSolstice - leftWinterSolstice) / MEAN_LUNAR_MONTH;
 
         // 冬至所在月首，即十一月
-        const auto firstNovember = findPrevNewMoon(leftWinterSolstice, solarAppCoord, moonAppCoord);
+        const auto firstNovember = findPrevNewMoon(leftWinterSolstice, elongation);
 
         // 十二月
-        const auto firstDecember = findNextNewMoon(firstNovember, solarAppCoord, moonAppCoord);
+        const auto firstDecember = findNextNewMoon(firstNovember, elongation);
 
         // 正月，也可能是闰十二月
-        auto firstJanuary = findNextNewMoon(firstDecember, solarAppCoord, moonAppCoord);
+        auto firstJanuary = findNextNewMoon(firstDecember, elongation);
 
         // 是否已经置闰
         bool hasLeap = false;
@@ -67,7 +70,7 @@ namespace astro {
             (firstDecember > terms[23].second || terms[23].second > firstJanuary)  // 中气大寒不在十二月，则存在闰十二月
         ) {
             *meybeLeapDecember = firstJanuary;
-            firstJanuary       = findNextNewMoon(firstJanuary, solarAppCoord, moonAppCoord);
+            firstJanuary       = findNextNewMoon(firstJanuary, elongation);
             hasLeap            = true;
         }
 
@@ -96,11 +99,11 @@ namespace astro {
             // 开始生成月表
             auto currMonth = firstJanuary;  // 当年正月
             for (std::size_t i = 0, termIdx{1}; i < 13; ++i) {
-                currMonth = findNextNewMoon(currMonth, solarAppCoord, moonAppCoord);
+                currMonth = findNextNewMoon(currMonth, elongation);
 
                 auto lastTerm = terms[termIdx].second;
 
-                auto nextMonth = findNextNewMoon(currMonth, solarAppCoord, moonAppCoord);
+                auto nextMonth = findNextNewMoon(currMonth, elongation);
 
                 months[i] = {currMonth, false};  // 先赋值后迭代，因为正月也存储
 
@@ -136,9 +139,9 @@ namespace astro {
                 // 去年大寒
                 const auto midTerm = findSolarTermForward(prevYearWinterSolstice, Term::MajorCold, solarAppCoord);
 
-                auto prevNovember = findPrevNewMoon(prevYearWinterSolstice, solarAppCoord, moonAppCoord);
+                auto prevNovember = findPrevNewMoon(prevYearWinterSolstice, elongation);
 
-                auto prevDecember = findNextNewMoon(prevNovember, solarAppCoord, moonAppCoord);
+                auto prevDecember = findNextNewMoon(prevNovember, elongation);
 
                 if (prevMouthCount >= 13 && (prevDecember > midTerm || midTerm > prevNovember)) prevHasLeap = true;
             }
@@ -146,11 +149,11 @@ namespace astro {
             // 开始生成月表，逆向
             auto currMonth = firstNovember;  // 当年冬至所在月首
             for (int i = 11, termIdx = 21; i >= 0; --i) {
-                currMonth = findPrevNewMoon(currMonth, solarAppCoord, moonAppCoord);
+                currMonth = findPrevNewMoon(currMonth, elongation);
 
                 auto prevTerm = terms[termIdx].second;
 
-                auto prevMonth = findPrevNewMoon(currMonth, solarAppCoord, moonAppCoord);
+                auto prevMonth = findPrevNewMoon(currMonth, elongation);
 
                 months[i] = {currMonth, false};
 
@@ -177,4 +180,10 @@ namespace astro {
         return {lunarYear, lunarMonth + 1, day, gregorianDate.hour, gregorianDate.minute, gregorianDate.second, months[lunarMonth].second};
     }
 
+    template LunarDate gregorianToLunar<validation::Checked>(const DateTime& gregorianDate, const reader::Data& data, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData);
+
+    template LunarDate gregorianToLunar<validation::DebugOnly>(const DateTime& gregorianDate, const reader::Data& data, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData);
+
+    template LunarDate gregorianToLunar<validation::Unchecked>(const DateTime& gregorianDate, const reader::Data& data, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData);
+
 }  // namespace astro
@@ -19,8 +19,11 @@
 
 #include "src/ast.h"
 #include "constant.h"
+#include "utils.h"
 
 namespace astro {
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
     LunarDate gregorianToLunar(const DateTime& gregorianDate, const reader::Data& data, const reader::Data& rData, const reader::Data& vData, const reader::Data& uData);
 }
 
@@ -0,0 +1,186 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file pool.cpp
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/08/20 21:14
+ * @brief
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#include "pool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+namespace astro {
+    ThreadPool::ThreadPool(const std::size_t threads) {
+        workers.reserve(std::max<std::size_t>(threads, 1));
+
+        for (std::size_t i{}; i < std::max<std::size_t>(threads, 1); ++i) workers.emplace_back([this] { work(); });
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+
+        condition.notify_all();
+
+        // 在互斥量与条件变量析构前等待所有工作线程退出
+        workers.clear();
+    }
+
+    std::size_t ThreadPool::size() const noexcept { return workers.size(); }
+
+    void ThreadPool::work() {
+        while (true) {
+            std::move_only_function<void()> task;
+
+            {
+                std::unique_lock lock(mutex);
+                condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+
+                // 停止前先清空队列，保证已提交任务的future都能就绪
+                if (tasks.empty()) return;
+
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+
+            task();
+        }
+    }
+
+    bool ThreadPool::runPending() {
+        std::move_only_function<void()> task;
+
+        {
+            std::lock_guard lock(mutex);
+
+            if (tasks.empty()) return false;
+
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+
+        task();
+
+        return true;
+    }
+
+    void ThreadPool::parallelFor(const std::size_t count, const std::function<void(std::size_t)>& body) {
+        if (!count) return;
+
+        // 下标由各线程动态领取，分配方式不影响每个下标的计算结果
+        std::atomic<std::size_t> next{};
+
+        const auto run = [&] {
+            for (std::size_t i; (i = next.fetch_add(1)) < count;) body(i);
+        };
+
+        runParticipants(std::min(size() + 1, count), [&](std::size_t) { run(); });
+    }
+
+    void ThreadPool::stealingFor(const std::size_t count, const std::function<void(std::size_t, std::size_t)>& body) {
+        if (!count) return;
+
+        if (count > std::numeric_limits<std::uint32_t>::max()) throw std::invalid_argument(std::format("stealingFor: {} indices exceed the 32-bit range", count));
+
+        const auto participants = std::min(size() + 1, count);
+
+        // 剩余区间[begin, end)打包为一个64位字(高32位为begin)，自取与窃取都以CAS修改同一个字
+        struct alignas(64) Range {
+            std::atomic<std::uint64_t> bounds;
+        };
+
+        const auto pack = [](std::uint64_t begin, std::uint64_t end) { return begin << 32 | end; };
+
+        std::vector<Range> ranges(participants);
+
+        for (std::size_t i{}; i < participants; ++i) ranges[i].bounds.store(pack(count * i / participants, count * (i + 1) / participants));
+
+        const auto take = [&](std::size_t participant) -> std::optional<std::size_t> {
+            auto& bounds = ranges[participant].bounds;
+
+            for (auto packed = bounds.load();;) {
+                if (packed >> 32 >= (packed & 0xffffffff)) return std::nullopt;
+
+                if (bounds.compare_exchange_weak(packed, packed + (std::uint64_t{1} << 32))) return packed >> 32;
+            }
+        };
+
+        // 自己的区间已空时调用，从剩余最多的区间后端取走一半(至少一个)放入自己的区间
+        const auto steal = [&](std::size_t thief) {
+            while (true) {
+                std::size_t victim = participants;
+                std::uint64_t snapshot{}, remaining{};
+
+                for (std::size_t i{}; i < participants; ++i) {
+                    if (i == thief) continue;
+
+                    const auto packed = ranges[i].bounds.load();
+                    const auto begin = packed >> 32, end = packed & 0xffffffff;
+
+                    if (begin < end && end - begin > remaining) {
+                        victim    = i;
+                        snapshot  = packed;
+                        remaining = end - begin;
+                    }
+                }
+
+                if (victim == participants) return false;
+
+                const auto end = snapshot & 0xffffffff, middle = end - (remaining + 1) / 2;
+
+                if (ranges[victim].bounds.compare_exchange_strong(snapshot, pack(snapshot >> 32, middle))) {
+                    ranges[thief].bounds.store(pack(middle, end));
+                    return true;
+                }
+            }
+        };
+
+        runParticipants(participants, [&](const std::size_t participant) {
+            while (true) {
+                while (const auto i = take(participant)) body(*i, participant);
+
+                if (!steal(participant)) return;
+            }
+        });
+    }
+
+    void ThreadPool::runParticipants(const std::size_t participants, const std::function<void(std::size_t)>& run) {
+        std::vector<std::future<void>> futures;
+
+        for (std::size_t i = 1; i < participants; ++i) futures.push_back(submit([&run, i] { run(i); }));
+
+        std::exception_ptr error;
+
+        try {
+            run(0);
+        } catch (...) { error = std::current_exception(); }
+
+        for (auto& future : futures) {
+            while (future.wait_for(std::chrono::seconds{}) != std::future_status::ready && runPending());
+
+            try {
+                future.get();
+            } catch (...) {
+                if (!error) error = std::current_exception();
+            }
+        }
+
+        if (error) std::rethrow_exception(error);
+    }
+}  // namespace astro
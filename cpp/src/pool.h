@@ -0,0 +1,82 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file pool.h
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/08/20 21:14
+ * @brief
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#ifndef POOL_H
+#define POOL_H
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace astro {
+    class ThreadPool {
+    public:
+        explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency());
+
+        ThreadPool(const ThreadPool&) = delete;
+
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool();
+
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        template<typename Func>
+        std::future<std::invoke_result_t<Func>> submit(Func&& task);
+
+        /**
+         * @brief 对[0, count)中每个下标调用body，调用线程也参与执行，返回前所有下标均已完成
+         * @note body中的异常会在所有任务结束后重新抛出；body可以嵌套调用本线程池的parallelFor/stealingFor
+         * */
+        void parallelFor(std::size_t count, const std::function<void(std::size_t)>& body);
+
+        /**
+         * @brief 对[0, count)中每个下标调用body(下标, 参与者编号)，调用线程也参与执行，返回前所有下标均已完成
+         * @details [0, count)均分为连续区间交给各参与者，参与者从自己区间的前端依次领取下标，取完后从剩余最多的区间后端窃取一半。
+         *          同一参与者领取的下标多为连续递增，参与者编号取值[0, size() + 1)且不会同时被两个线程使用，可用于索引每线程的暂存状态
+         * @throw std::invalid_argument count超过2^32 - 1
+         * @note body中的异常会在所有任务结束后重新抛出；body可以嵌套调用本线程池的parallelFor/stealingFor
+         * */
+        void stealingFor(std::size_t count, const std::function<void(std::size_t, std::size_t)>& body);
+
+    private:
+        std::vector<std::jthread> workers;
+        std::queue<std::move_only_function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool stopping = false;
+
+        void work();
+
+        ///< 从队列中取出一个任务在调用线程上执行，队列为空时返回false
+        bool runPending();
+
+        /**
+         * @brief 在调用线程与participants - 1个工作线程上分别执行run(参与者编号)，等待全部完成后重新抛出第一个异常
+         * @details 等待期间调用线程代为执行队列中的任务。调用线程本身是工作线程(嵌套调用)时，它提交的参与者可能排在队列中而没有空闲的工作线程，
+         *          只阻塞等待会死锁；代为执行后，队列为空时所等待的任务必已被某个线程取走，阻塞等待不再依赖其他排队的任务
+         * */
+        void runParticipants(std::size_t participants, const std::function<void(std::size_t)>& run);
+    };
+}  // namespace astro
+
+#include "pool.hpp"
+
+#endif  // POOL_H
@@ -0,0 +1,38 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file pool.hpp
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/08/20 21:14
+ * @brief
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#ifndef POOL_HPP
+#define POOL_HPP
+#pragma once
+
+namespace astro {
+    template<typename Func>
+    std::future<std::invoke_result_t<Func>> ThreadPool::submit(Func&& task) {
+        std::packaged_task<std::invoke_result_t<Func>()> packaged(std::forward<Func>(task));
+
+        auto future = packaged.get_future();
+
+        {
+            std::lock_guard lock(mutex);
+            tasks.emplace(std::move(packaged));
+        }
+
+        condition.notify_one();
+
+        return future;
+    }
+}  // namespace astro
+
+#endif  // POOL_HPP
@@ -0,0 +1,147 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file trig.cpp
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/08/22 14:37
+ * @brief
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#include "trig.h"
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <stdexcept>
+
+namespace astro {
+    constexpr double SINCOS_MAX_ARGUMENT = 1647099.0;
+
+    constexpr double SINCOS_MAX_ULP = 2.0;
+
+    namespace {
+        // 2/π
+        constexpr double INV_PIO2 = 6.36619772367581382433e-01;
+
+        // π/2的四段拆分，前两段各有33位有效数字，|n| < 2^20时n·PIO2_1与n·PIO2_2均无舍入；
+        // 末段用于x接近kπ/2、约化结果很小时保持相对精度
+        constexpr double PIO2_1  = 1.57079632673412561417e+00;
+        constexpr double PIO2_2  = 6.07710050630396597660e-11;
+        constexpr double PIO2_3  = 2.02226624871116645580e-21;
+        constexpr double PIO2_3T = 8.47842766036889956997e-32;
+
+        // fdlibm __kernel_sin / __kernel_cos 在[-π/4, π/4]上的极小极大系数
+        constexpr double S1 = -1.66666666666666324348e-01;
+        constexpr double S2 = 8.33333333332248946124e-03;
+        constexpr double S3 = -1.98412698298579493134e-04;
+        constexpr double S4 = 2.75573137070700676789e-06;
+        constexpr double S5 = -2.50507602534068634195e-08;
+        constexpr double S6 = 1.58969099521155010221e-10;
+
+        constexpr double C1 = 4.16666666666666019037e-02;
+        constexpr double C2 = -1.38888888888741095749e-03;
+        constexpr double C3 = 2.48015872894767294178e-05;
+        constexpr double C4 = -2.75573143513906633035e-07;
+        constexpr double C5 = 2.08757232129817482790e-09;
+        constexpr double C6 = -1.13596475577881948265e-11;
+
+        // 加上1.5·2^52后尾数低位即为最近整数，免去nearbyint与整数转换，便于向量化
+        constexpr double ROUNDING_SHIFT = 6755399441055744.0;
+
+        inline void kernel(const double x, double& sin, double& cos) {
+            const double shifted = x * INV_PIO2 + ROUNDING_SHIFT;
+            const double n       = shifted - ROUNDING_SHIFT;
+            const double r = (((x - n * PIO2_1) - n * PIO2_2) - n * PIO2_3) - n * PIO2_3T;
+
+            const double z = r * r;
+
+            const double s = r + r * z * (S1 + z * (S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)))));
+
+            // 1 - z/2的舍入误差单独补回
+            const double hz = 0.5 * z;
+            const double w  = 1.0 - hz;
+            const double c  = w + (((1.0 - w) - hz) + z * z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6))))));
+
+            // 象限的交换与取符号都用位运算完成，SSE2即可向量化
+            const std::uint64_t quadrant = std::bit_cast<std::uint64_t>(shifted);
+            const std::uint64_t swap     = 0 - (quadrant & 1);
+            const std::uint64_t sinBits  = std::bit_cast<std::uint64_t>(s);
+            const std::uint64_t cosBits  = std::bit_cast<std::uint64_t>(c);
+
+            sin = std::bit_cast<double>(((cosBits & swap) | (sinBits & ~swap)) ^ ((quadrant & 2) << 62));
+            cos = std::bit_cast<double>(((sinBits & swap) | (cosBits & ~swap)) ^ (((quadrant + 1) & 2) << 62));
+        }
+    }  // namespace
+
+    std::pair<double, double> sincos(const double x) {
+        if (std::abs(x) > SINCOS_MAX_ARGUMENT) return {std::sin(x), std::cos(x)};
+
+        double sin, cos;
+        kernel(x, sin, cos);
+
+        return {sin, cos};
+    }
+
+    void sincos(const std::span<const double> x, const std::span<double> sin, const std::span<double> cos) {
+        if (x.size() != sin.size() || x.size() != cos.size()) throw std::invalid_argument("sincos: size mismatch");
+
+        for (std::size_t i{}; i < x.size(); ++i) kernel(x[i], sin[i], cos[i]);
+
+        // 极少出现的超范围参数单独修正，不打断上面的向量化循环
+        for (std::size_t i{}; i < x.size(); ++i)
+            if (std::abs(x[i]) > SINCOS_MAX_ARGUMENT) {
+                sin[i] = std::sin(x[i]);
+                cos[i] = std::cos(x[i]);
+            }
+    }
+
+    constexpr std::size_t RECURRENCE_ANCHOR_INTERVAL = 64;
+
+    void PhaseRecurrence::anchor(const std::span<const double> phase, const std::span<const double> step, const std::span<const double> curvature) {
+        if (phase.size() != step.size() || phase.size() != curvature.size()) throw std::invalid_argument("PhaseRecurrence::anchor: size mismatch");
+
+        const auto size = phase.size();
+
+        std::vector<double> radians(size);
+
+        sinPhase.resize(size), cosPhase.resize(size);
+        sinStep.resize(size), cosStep.resize(size);
+        sinCurvature.resize(size), cosCurvature.resize(size);
+
+        // 以周为单位取小数部分后再转为弧度，整数周不影响三角函数值
+        for (std::size_t i{}; i < size; ++i) radians[i] = std::remainder(phase[i], 1.0) * 2 * std::numbers::pi;
+        sincos(radians, sinPhase, cosPhase);
+
+        for (std::size_t i{}; i < size; ++i) radians[i] = std::remainder(step[i], 1.0) * 2 * std::numbers::pi;
+        sincos(radians, sinStep, cosStep);
+
+        for (std::size_t i{}; i < size; ++i) radians[i] = std::remainder(curvature[i], 1.0) * 2 * std::numbers::pi;
+        sincos(radians, sinCurvature, cosCurvature);
+    }
+
+    void PhaseRecurrence::advance() {
+        for (std::size_t i{}; i < sinPhase.size(); ++i) {
+            const double sin = sinPhase[i] * cosStep[i] + cosPhase[i] * sinStep[i];
+            const double cos = cosPhase[i] * cosStep[i] - sinPhase[i] * sinStep[i];
+
+            sinPhase[i] = sin;
+            cosPhase[i] = cos;
+
+            const double sinNext = sinStep[i] * cosCurvature[i] + cosStep[i] * sinCurvature[i];
+            const double cosNext = cosStep[i] * cosCurvature[i] - sinStep[i] * sinCurvature[i];
+
+            sinStep[i] = sinNext;
+            cosStep[i] = cosNext;
+        }
+    }
+
+    std::span<const double> PhaseRecurrence::sin() const noexcept { return sinPhase; }
+
+    std::span<const double> PhaseRecurrence::cos() const noexcept { return cosPhase; }
+}  // namespace astro
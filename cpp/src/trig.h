@@ -0,0 +1,78 @@
+// Copyright (c) 2025. All rights reserved.
+// This source code is licensed under the CC BY-NC-SA
+// (Creative Commons Attribution-NonCommercial-NoDerivatives) License, By Xiao Songtao.
+// This software is protected by copyright law. Reproduction, distribution, or use for commercial
+// purposes is prohibited without the author's permission. If you have any questions or require
+// permission, please contact the author: 2207150234@st.sziit.edu.cn
+
+/**
+ * @file trig.h
+ * @author edocsitahw
+ * @version 1.1
+ * @date 2025/08/22 14:37
+ * @brief 级数求值专用的sincos
+ * @copyright CC BY-NC-SA 2025. All rights reserved.
+ * */
+#ifndef TRIG_H
+#define TRIG_H
+#pragma once
+
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace astro {
+    ///< Cody–Waite约化保持精确的参数范围 |x| ≤ 2^20·π/2，超出时退回std::sin/std::cos
+    extern const double SINCOS_MAX_ARGUMENT;
+
+    ///< 在SINCOS_MAX_ARGUMENT范围内相对libm的最大误差(ULP)
+    extern const double SINCOS_MAX_ULP;
+
+    /**
+     * @brief 同时求sin(x)与cos(x)
+     * @details 以四段π/2做Cody–Waite约化到[-π/4, π/4]，再用fdlibm的极小极大多项式求值，
+     *          按象限交换并取符号
+     * @return {sin(x), cos(x)}
+     * */
+    std::pair<double, double> sincos(double x);
+
+    /**
+     * @brief 批量sincos，约化与多项式部分无分支，循环可被编译器向量化
+     * @throw std::invalid_argument 三个区间长度不一致
+     * */
+    void sincos(std::span<const double> x, std::span<double> sin, std::span<double> cos);
+
+    ///< 等步长递推时重新锚定的步数间隔，限制旋转累积的舍入误差
+    extern const std::size_t RECURRENCE_ANCHOR_INTERVAL;
+
+    /**
+     * @brief 等步长序列上各项相位的三角递推
+     * @details 相位在锚点附近按二次式 φ_k = φ_0 + k·d1 + k(k-1)/2·d2 推进，对线性幅角(VSOP)d2为0，
+     *          对四次多项式幅角(LEA)在锚定间隔内三次以上的差分可以忽略。
+     *          每项保存e^{iφ_k}、e^{i(φ_{k+1}-φ_k)}与e^{i·d2}，每步两次复数乘法，无超越函数
+     * */
+    class PhaseRecurrence {
+    public:
+        /**
+         * @brief 以锚点处的相位φ_0及其一阶差分d1、二阶差分d2(单位均为周)重新锚定
+         * @details 差分应由幅角的解析表达直接求出，相邻历元的相位相减会把大数的舍入误差放大到递推中
+         * @throw std::invalid_argument 三个区间长度不一致
+         * */
+        void anchor(std::span<const double> phase, std::span<const double> step, std::span<const double> curvature);
+
+        ///< 推进到下一个历元
+        void advance();
+
+        [[nodiscard]] std::span<const double> sin() const noexcept;
+
+        [[nodiscard]] std::span<const double> cos() const noexcept;
+
+    private:
+        std::vector<double> sinPhase, cosPhase;
+        std::vector<double> sinStep, cosStep;
+        std::vector<double> sinCurvature, cosCurvature;
+    };
+}  // namespace astro
+
+
+#endif  // TRIG_H
@@ -14,7 +14,112 @@
  * @copyright CC BY-NC-SA 2025. All rights reserved.
  * */
 #include "utils.h"
+#include <array>
+#include <cmath>
+#include <limits>
 
 namespace astro {
+    void NeumaierSum::add(const double x) {
+        const double t = sum + x;
+
+        // 较大者在前，保证舍入误差被完整捕获
+        if (std::abs(sum) >= std::abs(x))
+            compensation += (sum - t) + x;
+        else
+            compensation += (x - t) + sum;
+
+        sum = t;
+    }
+
+    double NeumaierSum::value() const { return sum + compensation; }
+
+    double neumaierSum(const std::span<const double> values) {
+        NeumaierSum acc;
+
+        for (const auto x : values) acc.add(x);
+
+        return acc.value();
+    }
+
+    double blockedSum(const std::span<const double> values) {
+        constexpr std::size_t lanes = 8;
+
+        std::array<double, lanes> sum{};
+        std::array<double, lanes> compensation{};
+
+        const auto blocks = values.size() / lanes * lanes;
+
+        // 各路之间无依赖，分支以条件选择实现，循环可被编译器向量化
+        for (std::size_t i{}; i < blocks; i += lanes)
+            for (std::size_t j{}; j < lanes; ++j) {
+                const double x = values[i + j];
+                const double t = sum[j] + x;
+
+                compensation[j] += std::abs(sum[j]) >= std::abs(x) ? (sum[j] - t) + x : (x - t) + sum[j];
+                sum[j] = t;
+            }
+
+        NeumaierSum acc;
+
+        for (std::size_t j{}; j < lanes; ++j) acc.add(sum[j]);
+
+        for (std::size_t i = blocks; i < values.size(); ++i) acc.add(values[i]);
+
+        for (std::size_t j{}; j < lanes; ++j) acc.add(compensation[j]);
+
+        return acc.value();
+    }
+
+    constexpr double RATE_CONSISTENCY = 1e-3;
+
+    MonotonicCorrector::MonotonicCorrector(const double tol) : tol(tol), lower(-std::numeric_limits<double>::infinity()), upper(std::numeric_limits<double>::infinity()) {}
+
+    double MonotonicCorrector::next(const double x, const double residual, const double rate) {
+        // 根位于(lower, upper)内
+        (residual * rate < 0 ? lower : upper) = x;
+
+        double slope     = rate;
+        double curvature = 0;
+
+        if (hasPrevious) {
+            const auto secant = (residual - prevResidual) / (x - prevX);
+
+            if (std::abs(secant - (rate + prevRate) / 2) <= RATE_CONSISTENCY * std::abs(secant))
+                curvature = (rate - prevRate) / (x - prevX);
+            else
+                slope = secant;
+        }
+
+        // Halley修正 δ = (f / f') / (1 - f·f'' / (2f'^2))，curvature为0时即牛顿步
+        auto delta = residual / slope;
+        delta /= 1 - delta * curvature / (2 * slope);
+
+        prevX        = x;
+        prevResidual = residual;
+        prevRate     = rate;
+        hasPrevious  = true;
+
+        if (std::abs(delta) < tol) {
+            done = true;
+            return x - delta;
+        }
+
+        const auto next = x - delta;
+
+        if (next > lower && next < upper) return next;
+
+        return std::isfinite(lower) && std::isfinite(upper) ? (lower + upper) / 2 : next;
+    }
+
+    bool MonotonicCorrector::converged() const noexcept { return done; }
+
+    double fraction(const double x) { return x - std::floor(x); }
+
+    double revolutions(const double phase, const double rate, const double t) {
+        const double product = rate * t;
+        const double error   = std::fma(rate, t, -product);
+
+        return fraction(fraction(phase) + fraction(product) + error);
+    }
 
 }  // namespace astro
@@ -19,6 +19,12 @@
 
 #include <type_traits>
 #include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <span>
 
 namespace astro {
     template<typename F, typename A, typename R>
@@ -44,8 +50,191 @@ namespace astro {
         requires arithmeticFunc<Func, A, R>
     double findRootBackward(const Func& func, A x, double step, double tol = 1e-6);
 
+    /**
+     * @brief 在x附近求根，[x - radius, x + radius]不含变号时半径加倍，至多扩展maxExpansions次
+     * @throw std::runtime_error 扩展maxExpansions次后仍未找到变号区间
+     * */
+    template<typename Func, typename A, typename R = std::invoke_result_t<Func, A>>
+        requires arithmeticFunc<Func, A, R>
+    double findRootNear(const Func& func, A x, double radius, double tol = 1e-6, int maxExpansions = 32);
+
+    /**
+     * @brief 以近似模型给出的根x与斜率slope为起点，对func做至多steps次固定斜率的牛顿步
+     * @details 每步只求一次func，步长小于tol即返回；否则在[x - radius, x + radius]上退回区间求根，radius应覆盖近似模型的误差上界
+     * @throw std::runtime_error 退回的区间求根找不到变号区间
+     * */
+    template<typename Func, typename A, typename R = std::invoke_result_t<Func, A>>
+        requires arithmeticFunc<Func, A, R>
+    double refineRoot(const Func& func, A x, double slope, double radius, double tol = 1e-6, int steps = 2);
+
+    // 同时给出函数值与变化率的函数: f(x).value, f(x).rate
+    template<typename Func>
+    concept rateFunc = requires(Func f, double x) {
+        { f(x).value } -> std::convertible_to<double>;
+        { f(x).rate } -> std::convertible_to<double>;
+    };
+
+    ///< 相邻两次求值的差商与两端速率均值的相对差在此以内时认为速率可信，否则改用割线斜率
+    extern const double RATE_CONSISTENCY;
+
+    /**
+     * @brief 单调函数求根的预测-校正步
+     * @details 首步为牛顿步；此后速率与差商一致时以相邻两次速率的差商作二阶导做Halley步，否则以割线代替速率。
+     *          每次求值的函数值与速率全部复用，并维护已知的异号区间，步出区间时改为二分。批量求解时每个根一份
+     * */
+    class MonotonicCorrector {
+    public:
+        explicit MonotonicCorrector(double tol);
+
+        ///< 记录x处的残差与速率，返回下一个求值点；修正量小于容差时返回最终的根并标记收敛
+        double next(double x, double residual, double rate);
+
+        [[nodiscard]] bool converged() const noexcept;
+
+    private:
+        double tol;
+        double lower, upper;
+        double prevX{}, prevResidual{}, prevRate{};
+        bool hasPrevious = false;
+        bool done        = false;
+    };
+
+    ///< 单调函数func(x).value = target的预测-校正求根，guess为预测值，修正量小于tol即返回
+    template<typename Func>
+        requires rateFunc<Func>
+    double solveMonotonic(const Func& func, double target, double guess, double tol, int maxIter = 16);
+
+    // 批量求值函数: f(x, samples)对x中每个点写出一个带value、rate的样本
+    template<typename Func, typename Sample>
+    concept batchRateFunc = requires(Func f, std::span<const double> x, std::span<Sample> samples, Sample sample) {
+        f(x, samples);
+        { sample.value } -> std::convertible_to<double>;
+        { sample.rate } -> std::convertible_to<double>;
+    };
+
+    /**
+     * @brief 批量求解func(x).value = target[i]，所有根同步推进
+     * @details 每轮只对仍未收敛的根做一次批量求值，收敛的根随即退出，各根的迭代与单独求解相同
+     * @throw std::invalid_argument 区间长度不一致
+     * @throw std::runtime_error maxIter轮后仍有根未收敛
+     * */
+    template<typename Sample, typename Func>
+        requires batchRateFunc<Func, Sample>
+    void solveMonotonic(const Func& func, std::span<const double> target, std::span<const double> guess, std::span<double> roots, double tol, int maxIter = 16);
+
+    /**
+     * @brief 惰性的单趟事件序列，用法同std::generator<T>，可用于范围for与std::views
+     * @details next每次返回下一个事件，返回空表示序列结束；只在取值时求下一个事件，消费者随时停止都不会多求一个。
+     *          不用std::generator：<format>自GCC 13起提供，而<generator>要到GCC 14，libc++至今未提供，用它会抬高编译器要求
+     * */
+    template<typename T>
+    class EventStream : public std::ranges::view_interface<EventStream<T>> {
+    public:
+        class iterator {
+        public:
+            using value_type      = T;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            explicit iterator(EventStream* stream) : stream(stream) {}
+
+            const T& operator*() const { return *stream->current; }
+
+            iterator& operator++();
+
+            void operator++(int) { ++*this; }
+
+            bool operator==(std::default_sentinel_t) const { return !stream->current; }
+
+        private:
+            EventStream* stream = nullptr;
+        };
+
+        explicit EventStream(std::move_only_function<std::optional<T>()> next) : next(std::move(next)) {}
+
+        ///< 求出第一个事件，单趟序列只能调用一次
+        iterator begin();
+
+        std::default_sentinel_t end() const noexcept { return {}; }
+
+    private:
+        std::move_only_function<std::optional<T>()> next;
+        std::optional<T> current;
+    };
+
     template<typename T>
     void rangeCheck(T x, T a, T b);
+
+    enum class Summation {
+        ///< long double累加，x86-64上为x87指令，无法向量化
+        LongDouble,
+        ///< double累加，Neumaier补偿
+        Neumaier,
+        ///< 多路独立的Neumaier补偿累加，适合向量化
+        Blocked
+    };
+
+    struct NeumaierSum {
+        double sum{};
+        double compensation{};
+
+        void add(double x);
+
+        [[nodiscard]] double value() const;
+    };
+
+    double neumaierSum(std::span<const double> values);
+
+    double blockedSum(std::span<const double> values);
+
+    ///< x的小数部分，落在[0, 1)
+    double fraction(double x);
+
+    /**
+     * @brief 以周为单位的线性幅角phase + rate·t约化到[0, 1)
+     * @details rate·t的舍入误差由fma求出后补回，大t时不丢失小数部分的精度
+     * */
+    double revolutions(double phase, double rate, double t);
+
+    namespace validation {
+        ///< 始终检查中间量的取值范围
+        struct Checked {
+            static constexpr bool enabled = true;
+        };
+
+        ///< 仅在调试构建(未定义NDEBUG)中检查
+        struct DebugOnly {
+#ifdef NDEBUG
+            static constexpr bool enabled = false;
+#else
+            static constexpr bool enabled = true;
+#endif
+        };
+
+        ///< 不做任何检查，热路径上不产生分支与格式化代码
+        struct Unchecked {
+            static constexpr bool enabled = false;
+        };
+    }  // namespace validation
+
+    template<typename P>
+    concept validationPolicy = requires {
+        { P::enabled } -> std::convertible_to<bool>;
+    };
+
+    // 默认策略由编译选项决定: ASTRO_VALIDATION_CHECKED / ASTRO_VALIDATION_UNCHECKED，否则为DebugOnly
+#if defined(ASTRO_VALIDATION_CHECKED)
+    using DefaultValidation = validation::Checked;
+#elif defined(ASTRO_VALIDATION_UNCHECKED)
+    using DefaultValidation = validation::Unchecked;
+#else
+    using DefaultValidation = validation::DebugOnly;
+#endif
+
+    template<typename Policy, typename T>
+        requires validationPolicy<Policy>
+    void validate(T x, T a, T b);
 }  // namespace astro
 
 #include "utils.hpp"
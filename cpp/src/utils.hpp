@@ -17,8 +17,12 @@
 #define UTILS_HPP
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <stdexcept>
 #include <format>
+#include <vector>
 
 namespace astro {
     template<typename T, typename R>
@@ -127,7 +131,10 @@ namespace astro {
         double a = x;
         double b = x + step;
 
-        while (func(a) * func(b) > 0) b += step;
+        // 起点的函数值不随b变化，只求一次
+        const double fa = func(a);
+
+        while (fa * func(b) > 0) b += step;
 
         return brent(func, a, b, tol, 1000);
     }
@@ -138,15 +145,131 @@ namespace astro {
         double a = x;
         double b = x - step;
 
-        while (func(a) * func(b) > 0) b -= step;
+        const double fa = func(a);
+
+        while (fa * func(b) > 0) b -= step;
+
+        return brent(func, a, b, tol, 1000);
+    }
+
+    template<typename Func, typename A, typename R>
+        requires arithmeticFunc<Func, A, R>
+    double findRootNear(const Func& func, A x, double radius, double tol, int maxExpansions) {
+        double a = x - radius;
+        double b = x + radius;
+
+        // 近似根附近的区间不一定包含根，逐步向两侧加倍扩展
+        for (int i = 0; func(a) * func(b) > 0; ++i) {
+            if (i >= maxExpansions) throw std::runtime_error(std::format("findRootNear: no sign change within {} of {} after {} expansions", radius, static_cast<double>(x), maxExpansions));
+
+            radius *= 2;
+            a = x - radius;
+            b = x + radius;
+        }
 
         return brent(func, a, b, tol, 1000);
     }
 
+    template<typename Func, typename A, typename R>
+        requires arithmeticFunc<Func, A, R>
+    double refineRoot(const Func& func, A x, double slope, double radius, double tol, int steps) {
+        auto root = static_cast<double>(x);
+
+        // 近似模型的斜率与精确函数只差截断误差量级，每步误差按其相对差缩小
+        for (int i = 0; i < steps; ++i) {
+            const auto delta = func(root) / slope;
+
+            root -= delta;
+
+            if (std::abs(delta) < tol) return root;
+        }
+
+        return findRootNear(func, root, radius, tol);
+    }
+
+    template<typename Func>
+        requires rateFunc<Func>
+    double solveMonotonic(const Func& func, double target, double guess, double tol, int maxIter) {
+        MonotonicCorrector corrector(tol);
+
+        double x = guess;
+
+        for (int i = 1;; ++i) {
+            const auto sample = func(x);
+
+            x = corrector.next(x, static_cast<double>(sample.value) - target, sample.rate);
+
+            if (corrector.converged()) return x;
+
+            if (i >= maxIter) throw std::runtime_error(std::format("solveMonotonic: did not converge after {} evaluations", maxIter));
+        }
+    }
+
+    template<typename Sample, typename Func>
+        requires batchRateFunc<Func, Sample>
+    void solveMonotonic(const Func& func, std::span<const double> target, std::span<const double> guess, std::span<double> roots, double tol, int maxIter) {
+        if (target.size() != guess.size() || roots.size() != guess.size())
+            throw std::invalid_argument(std::format("solveMonotonic: {} targets, {} guesses and {} roots", target.size(), guess.size(), roots.size()));
+
+        std::ranges::copy(guess, roots.begin());
+
+        std::vector<MonotonicCorrector> correctors(guess.size(), MonotonicCorrector(tol));
+
+        // 仍在迭代的根的下标，以及按其顺序紧凑排列的求值点与样本
+        std::vector<std::size_t> active(guess.size());
+        std::iota(active.begin(), active.end(), std::size_t{});
+
+        std::vector<double> x;
+        std::vector<Sample> samples;
+
+        for (int i = 1; !active.empty(); ++i) {
+            if (i > maxIter) throw std::runtime_error(std::format("solveMonotonic: {} roots did not converge after {} evaluations", active.size(), maxIter));
+
+            x.resize(active.size());
+            samples.resize(active.size());
+
+            for (std::size_t k{}; k < active.size(); ++k) x[k] = roots[active[k]];
+
+            func(std::span<const double>(x), std::span<Sample>(samples));
+
+            std::size_t remaining{};
+
+            for (std::size_t k{}; k < active.size(); ++k) {
+                const auto j = active[k];
+
+                roots[j] = correctors[j].next(x[k], static_cast<double>(samples[k].value) - target[j], samples[k].rate);
+
+                if (!correctors[j].converged()) active[remaining++] = j;
+            }
+
+            active.resize(remaining);
+        }
+    }
+
+    template<typename T>
+    typename EventStream<T>::iterator& EventStream<T>::iterator::operator++() {
+        stream->current = stream->next();
+
+        return *this;
+    }
+
+    template<typename T>
+    typename EventStream<T>::iterator EventStream<T>::begin() {
+        current = next();
+
+        return iterator{this};
+    }
+
     template<typename T>
     void rangeCheck(T x, T a, T b) {
         if (x < a || x > b) throw std::out_of_range(std::format("{} is out of range [{}, {}]", x, a, b));
     }
+
+    template<typename Policy, typename T>
+        requires validationPolicy<Policy>
+    void validate(T x, T a, T b) {
+        if constexpr (Policy::enabled) rangeCheck(x, a, b);
+    }
 }  // namespace astro
 
 #endif  // UTILS_HPP
@@ -14,50 +14,89 @@
  * @copyright CC BY-NC-SA 2025. All rights reserved.
  * */
 #include "vsop.h"
+#include "trig.h"
 #include "utils.h"
+#include <algorithm>
+#include <cmath>
 #include <format>
 #include <numbers>
+#include <stdexcept>
 
 namespace astro::vsop {
-    double lambdaMercury(const double t) { return 4.402608631669 + 26087.90314068555 * t; }
+    constexpr std::array<std::array<double, 2>, 17> LAMBDA_COEFFICIENTS = {{
+        {4.402608631669, 26087.90314068555},  // 水星
+        {3.176134461576, 10213.28554743445},  // 金星
+        {1.753470369433, 6283.075850353215},  // 地月系
+        {6.203500014141, 3340.612434145457},  // 火星
+        {4.091360003050, 1731.170452721855},  // 灶神星
+        {1.713740719173, 1704.450855027201},  // 虹神星
+        {5.598641292287, 1428.948917844273},  // 班贝格星
+        {2.805136360408, 1364.756513629990},  // 谷神星
+        {2.326989734620, 1361.923207632842},  // 智神星
+        {0.599546107035, 529.6909615623250},  // 木星
+        {0.874018510107, 213.2990861084880},  // 土星
+        {5.481225395663, 74.78165903077800},  // 天王星
+        {5.311897933164, 38.13297222612500},  // 海王星
+        {0, 0.3595362285049309},              // 冥王星
+        {5.198466400630, 77713.7714481804},   // 月球D
+        {1.627905136020, 84334.6615717837},   // 月球F
+        {2.35555638750, 83286.9142477147}     // 月球l
+    }};
 
-    double lambdaVenus(const double t) { return 3.176134461576 + 10213.28554743445 * t; }
+    namespace {
+        double linearLambda(const std::size_t index, const double t) { return LAMBDA_COEFFICIENTS[index][0] + LAMBDA_COEFFICIENTS[index][1] * t; }
+    }  // namespace
 
-    double lambdaEarthMoon(const double t) { return 1.753470369433 + 6283.075850353215 * t; }
+    double lambdaMercury(const double t) { return linearLambda(0, t); }
 
-    double lambdaMars(const double t) { return 6.203500014141 + 3340.612434145457 * t; }
+    double lambdaVenus(const double t) { return linearLambda(1, t); }
 
-    double lambdaVesta(const double t) { return 4.091360003050 + 1731.170452721855 * t; }
+    double lambdaEarthMoon(const double t) { return linearLambda(2, t); }
 
-    double lambdaIris(const double t) { return 1.713740719173 + 1704.450855027201 * t; }
+    double lambdaMars(const double t) { return linearLambda(3, t); }
 
-    double lambdaBamberga(const double t) { return 5.598641292287 + 1428.948917844273 * t; }
+    double lambdaVesta(const double t) { return linearLambda(4, t); }
 
-    double lambdaCeres(const double t) { return 2.805136360408 + 1364.756513629990 * t; }
+    double lambdaIris(const double t) { return linearLambda(5, t); }
 
-    double lambdaPallas(const double t) { return 2.326989734620 + 1361.923207632842 * t; }
+    double lambdaBamberga(const double t) { return linearLambda(6, t); }
 
-    double lambdaJupiter(const double t) { return 0.599546107035 + 529.6909615623250 * t; }
+    double lambdaCeres(const double t) { return linearLambda(7, t); }
 
-    double lambdaSaturn(const double t) { return 0.874018510107 + 213.2990861084880 * t; }
+    double lambdaPallas(const double t) { return linearLambda(8, t); }
 
-    double lambdaUranus(const double t) { return 5.481225395663 + 74.78165903077800 * t; }
+    double lambdaJupiter(const double t) { return linearLambda(9, t); }
 
-    double lambdaNeptune(const double t) { return 5.311897933164 + 38.13297222612500 * t; }
+    double lambdaSaturn(const double t) { return linearLambda(10, t); }
 
-    double lambdaPluto(const double t) { return 0.3595362285049309 * t; }
+    double lambdaUranus(const double t) { return linearLambda(11, t); }
 
-    double lambdaMoonD(const double t) { return 5.198466400630 + 77713.7714481804 * t; }
+    double lambdaNeptune(const double t) { return linearLambda(12, t); }
 
-    double lambdaMoonF(const double t) { return 1.627905136020 + 84334.6615717837 * t; }
+    double lambdaPluto(const double t) { return linearLambda(13, t); }
 
-    double lambdaMoonL(const double t) { return 2.35555638750 + 83286.9142477147 * t; }
+    double lambdaMoonD(const double t) { return linearLambda(14, t); }
+
+    double lambdaMoonF(const double t) { return linearLambda(15, t); }
+
+    double lambdaMoonL(const double t) { return linearLambda(16, t); }
 
     extern const std::vector<std::function<double(double)>> LAMBDA_TABLE = {lambdaMercury,  lambdaVenus, lambdaEarthMoon, lambdaMars,    lambdaVesta,  lambdaIris,
                                                                             lambdaBamberga, lambdaCeres, lambdaPallas,    lambdaJupiter, lambdaSaturn, lambdaUranus,
                                                                             lambdaNeptune,  lambdaPluto, lambdaMoonD,     lambdaMoonF,   lambdaMoonL};
 
+    std::array<double, 17> fundamentalRevolutions(const double t) {
+        std::array<double, 17> result{};
+
+        for (std::size_t i{}; i < result.size(); ++i) result[i] = revolutions(LAMBDA_COEFFICIENTS[i][0] / (2 * std::numbers::pi), LAMBDA_COEFFICIENTS[i][1] / (2 * std::numbers::pi), t);
+
+        return result;
+    }
+
     double calcPhi(const double t, const std::vector<std::shared_ptr<reader::Literal>>& data) {
+        // 在周数空间中组合各幅角，结果落在[0, 2π)
+        const auto revolution = fundamentalRevolutions(t);
+
         double result{};
 
         for (std::size_t i{}; i < data.size(); ++i)
@@ -65,14 +104,14 @@ namespace astro::vsop {
                 [&]<typename T>(T&& arg) -> double {
                     if constexpr (std::is_same_v<T, std::string>) {
                         std::cerr << "Waring: " << arg << " is not a valid term in the VSOP model. It will be ignored." << std::endl;
-                        return std::stod(arg) * LAMBDA_TABLE[i](t);
+                        return std::stod(arg) * revolution[i];
                     } else
-                        return arg * LAMBDA_TABLE[i](t);
+                        return arg * revolution[i];
                 },
                 data[i]->value()
             );
 
-        return result;
+        return fraction(result) * 2 * std::numbers::pi;
     }
 
     double calcSeries(const double t, const std::shared_ptr<reader::Term>& term) {
@@ -108,6 +147,44 @@ namespace astro::vsop {
         return x;
     }
 
+    constexpr int KEPLER_ITERATIONS = 2;
+
+    namespace {
+        // Markley(1995)三次初值 + 固定次数的Halley迭代，无数据相关分支，便于向量化
+        inline double keplerKernel(const double eccentricity, const double meanAnomaly) {
+            constexpr auto pi = std::numbers::pi;
+
+            // 平近点角归约到[-π, π]
+            const auto M = meanAnomaly - 2 * pi * std::nearbyint(meanAnomaly / (2 * pi));
+
+            const auto alpha = (3 * pi * pi + 1.6 * pi * (pi - std::abs(M)) / (1 + eccentricity)) / (pi * pi - 6);
+            const auto d     = 3 * (1 - eccentricity) + alpha * eccentricity;
+            const auto q     = 2 * alpha * d * (1 - eccentricity) - M * M;
+            const auto r     = 3 * alpha * d * (d - 1 + eccentricity) * M + M * M * M;
+            const auto w     = binPow(std::cbrt(std::abs(r) + std::sqrt(q * q * q + r * r)), 2);
+
+            auto E = (2 * r * w / (w * w + w * q + q * q) + M) / d;
+
+            for (int i{}; i < KEPLER_ITERATIONS; ++i) {
+                const auto s  = eccentricity * std::sin(E);
+                const auto f  = E - s - M;
+                const auto f1 = 1 - eccentricity * std::cos(E);
+
+                E -= f / (f1 - 0.5 * f * s / f1);
+            }
+
+            return E;
+        }
+    }  // namespace
+
+    double solveKepler(const double eccentricity, const double meanAnomaly) { return keplerKernel(eccentricity, meanAnomaly); }
+
+    void solveKepler(std::span<const double> eccentricity, std::span<const double> meanAnomaly, std::span<double> eccentricAnomaly) {
+        if (eccentricity.size() != meanAnomaly.size() || eccentricAnomaly.size() != meanAnomaly.size()) throw std::invalid_argument("solveKepler: span sizes do not match");
+
+        for (std::size_t i{}; i < meanAnomaly.size(); ++i) eccentricAnomaly[i] = keplerKernel(eccentricity[i], meanAnomaly[i]);
+    }
+
     double calcTrueAnomaly(double eccentricAnomaly, double eccentricity) { return 2 * std::atan(std::sqrt((1 + eccentricity) / (1 - eccentricity)) * std::tan(eccentricAnomaly / 2)); }
 
     double calcHeliocentricDistance(double a, double eccentricity, double trueAnomaly) { return a * (1 - eccentricity * eccentricity) / (1 + eccentricity * std::cos(trueAnomaly)); }
@@ -116,10 +193,17 @@ namespace astro::vsop {
     std::tuple<T, T, T, T, T, T> calcCoefficents(double t, const reader::Data& data) {
         double series[6] = {0};
 
+        // VSOP2013以千年为时间单位
+        const auto tm = t / 10;
+
         for (const auto& table : data.tables) {
-            auto key = std::get<int>(dynamic_cast<reader::Integer*>(table->header->fields[2].get())->value()) - 1;
+            auto key   = std::get<int>(dynamic_cast<reader::Integer*>(table->header->fields[2].get())->value()) - 1;
+            auto power = std::get<int>(dynamic_cast<reader::Integer*>(table->header->fields[3].get())->value());
 
-            for (int i = 1; i < table->terms.size(); ++i) series[key] += binPow(t, i) * calcSeries(t, table->terms[i]);
+            double sum{};
+            for (const auto& term : table->terms) sum += calcSeries(tm, term);
+
+            series[key] += binPow(tm, power) * sum;
         }
 
         return {series[0], series[1], series[2], series[3], series[4], series[5]};
@@ -127,60 +211,567 @@ namespace astro::vsop {
 
     template std::tuple<double, double, double, double, double, double> calcCoefficents(double t, const reader::Data& data);
 
+    CompiledData compile(const reader::Data& data) {
+        CompiledData result;
+
+        for (const auto& table : data.tables) {
+            CompiledTable compiled;
+
+            compiled.variable = std::get<int>(dynamic_cast<reader::Integer*>(table->header->fields[2].get())->value()) - 1;
+            compiled.power    = std::get<int>(dynamic_cast<reader::Integer*>(table->header->fields[3].get())->value());
+            rangeCheck(compiled.variable, 0, 5);
+
+            struct Row {
+                std::array<std::int32_t, 17> multipliers;
+                double sinAmplitude, cosAmplitude;
+            };
+
+            std::vector<Row> rows;
+            rows.reserve(table->terms.size());
+
+            for (const auto& term : table->terms) {
+                Row row{};
+
+                for (std::size_t i{}; i < term->coefficients.size() && i < row.multipliers.size(); ++i)
+                    row.multipliers[i] = static_cast<std::int32_t>(std::visit(
+                        []<typename T>(T&& arg) -> double {
+                            if constexpr (std::is_same_v<std::decay_t<T>, std::string>)
+                                return std::stod(arg);
+                            else
+                                return arg;
+                        },
+                        term->coefficients[i]->value()
+                    ));
+
+                row.sinAmplitude = std::get<double>(term->sinMantissa->value()) * std::pow(10, std::get<int>(term->sinExponent->value()));
+                row.cosAmplitude = std::get<double>(term->cosMantissa->value()) * std::pow(10, std::get<int>(term->cosExponent->value()));
+
+                rows.push_back(row);
+            }
+
+            // 同一表中各项的时间幂次相同，按振幅降序即按有效时间范围内的最大贡献降序
+            std::ranges::sort(rows, std::greater{}, [](const Row& row) { return std::hypot(row.sinAmplitude, row.cosAmplitude); });
+
+            compiled.tailAmplitude.assign(rows.size() + 1, 0.0);
+
+            for (std::size_t i = rows.size(); i-- > 0;) compiled.tailAmplitude[i] = compiled.tailAmplitude[i + 1] + std::hypot(rows[i].sinAmplitude, rows[i].cosAmplitude);
+
+            for (const auto& row : rows) {
+                compiled.multipliers.push_back(row.multipliers);
+                compiled.sinAmplitude.push_back(row.sinAmplitude);
+                compiled.cosAmplitude.push_back(row.cosAmplitude);
+            }
+
+            ++result.tableCount[compiled.variable];
+            result.tables.push_back(std::move(compiled));
+        }
+
+        return result;
+    }
+
+    constexpr int WINDOW_TAYLOR_DEGREE = 6;
+
+    namespace {
+        ///< ∑ c_k·x^k
+        double evalPolynomial(const std::vector<double>& coefficients, const double x) {
+            double result{};
+
+            for (auto it = coefficients.rbegin(); it != coefficients.rend(); ++it) result = result * x + *it;
+
+            return result;
+        }
+
+        void rebuildTail(CompiledTable& table) {
+            table.tailAmplitude.assign(table.multipliers.size() + 1, 0.0);
+
+            for (std::size_t i = table.multipliers.size(); i-- > 0;) table.tailAmplitude[i] = table.tailAmplitude[i + 1] + std::hypot(table.sinAmplitude[i], table.cosAmplitude[i]);
+        }
+    }  // namespace
+
+    WindowCompilation compile(const reader::Data& data, const double t0, const double t1, const double tolerance) {
+        if (!(t0 < t1) || t0 < -100 || t1 > 100) throw std::invalid_argument(std::format("Invalid window [{}, {}] for Vsop2013.", t0, t1));
+
+        auto compiled = compile(data);
+
+        const auto center    = (t0 + t1) / 20;
+        const auto halfWidth = (t1 - t0) / 20;
+        const auto edge      = std::max(std::abs(t0), std::abs(t1)) / 10;
+
+        const auto revolution = fundamentalRevolutions(center);
+
+        // 泰勒余项 |g - P_D| <= A·(|ω|h)^(D+1)/(D+1)!
+        double factorial = 1;
+        for (int i = 2; i <= WINDOW_TAYLOR_DEGREE + 1; ++i) factorial *= i;
+
+        struct Candidate {
+            std::size_t table, term;
+            double bound;
+            bool fold;
+        };
+
+        std::array<std::vector<Candidate>, 6> candidates;
+
+        WindowReport report;
+
+        for (std::size_t i{}; i < compiled.tables.size(); ++i) {
+            const auto& table = compiled.tables[i];
+            const auto scale  = binPow(edge, table.power);
+
+            report.originalTerms += table.multipliers.size();
+
+            for (std::size_t j{}; j < table.multipliers.size(); ++j) {
+                double frequency{};
+                for (std::size_t k{}; k < LAMBDA_COEFFICIENTS.size(); ++k) frequency += table.multipliers[j][k] * LAMBDA_COEFFICIENTS[k][1];
+
+                const auto amplitude = std::hypot(table.sinAmplitude[j], table.cosAmplitude[j]) * scale;
+                const auto foldBound = amplitude * std::pow(std::abs(frequency) * halfWidth, WINDOW_TAYLOR_DEGREE + 1) / factorial;
+
+                candidates[table.variable].push_back({i, j, std::min(amplitude, foldBound), foldBound < amplitude});
+            }
+        }
+
+        std::vector<std::vector<bool>> removed(compiled.tables.size());
+        for (std::size_t i{}; i < compiled.tables.size(); ++i) removed[i].assign(compiled.tables[i].multipliers.size(), false);
+
+        for (std::size_t variable{}; variable < candidates.size(); ++variable) {
+            auto& list = candidates[variable];
+            std::ranges::sort(list, std::less{}, &Candidate::bound);
+
+            auto& polynomial = compiled.polynomial[variable];
+
+            for (const auto& candidate : list) {
+                if (report.maxError[variable] + candidate.bound > tolerance) break;
+
+                report.maxError[variable] += candidate.bound;
+                removed[candidate.table][candidate.term] = true;
+
+                if (!candidate.fold) {
+                    ++report.droppedTerms;
+                    continue;
+                }
+
+                ++report.foldedTerms;
+
+                const auto& table = compiled.tables[candidate.table];
+
+                double phase{}, frequency{};
+                for (std::size_t k{}; k < revolution.size(); ++k) {
+                    phase += table.multipliers[candidate.term][k] * revolution[k];
+                    frequency += table.multipliers[candidate.term][k] * LAMBDA_COEFFICIENTS[k][1];
+                }
+
+                const auto [sinPhase, cosPhase] = sincos(fraction(phase) * 2 * std::numbers::pi);
+
+                // S·sinφ + C·cosφ 在中心处展开为 P·cos(ωx) + Q·sin(ωx)，x = t - center
+                const auto P = table.sinAmplitude[candidate.term] * sinPhase + table.cosAmplitude[candidate.term] * cosPhase;
+                const auto Q = table.sinAmplitude[candidate.term] * cosPhase - table.cosAmplitude[candidate.term] * sinPhase;
+
+                std::vector<double> series(WINDOW_TAYLOR_DEGREE + 1);
+
+                double term = 1;
+                for (int k{}; k <= WINDOW_TAYLOR_DEGREE; ++k) {
+                    const auto sign = (k / 2) % 2 ? -1.0 : 1.0;
+
+                    series[k] = sign * (k % 2 ? Q : P) * term;
+                    term *= frequency / (k + 1);
+                }
+
+                // t^n = (center + x)^n
+                std::vector<double> power{1.0};
+                for (int n{}; n < table.power; ++n) {
+                    std::vector<double> next(power.size() + 1, 0.0);
+
+                    for (std::size_t k{}; k < power.size(); ++k) {
+                        next[k] += power[k] * center;
+                        next[k + 1] += power[k];
+                    }
+
+                    power = std::move(next);
+                }
+
+                if (polynomial.size() < series.size() + power.size() - 1) polynomial.resize(series.size() + power.size() - 1, 0.0);
+
+                for (std::size_t a{}; a < series.size(); ++a)
+                    for (std::size_t b{}; b < power.size(); ++b) polynomial[a + b] += series[a] * power[b];
+            }
+        }
+
+        WindowCompilation result;
+        result.data.polynomial       = std::move(compiled.polynomial);
+        result.data.polynomialCenter = center;
+        result.data.validFrom        = t0;
+        result.data.validTo          = t1;
+
+        for (std::size_t i{}; i < compiled.tables.size(); ++i) {
+            const auto& table = compiled.tables[i];
+
+            CompiledTable kept{table.variable, table.power, {}, {}, {}, {}};
+
+            for (std::size_t j{}; j < table.multipliers.size(); ++j)
+                if (!removed[i][j]) {
+                    kept.multipliers.push_back(table.multipliers[j]);
+                    kept.sinAmplitude.push_back(table.sinAmplitude[j]);
+                    kept.cosAmplitude.push_back(table.cosAmplitude[j]);
+                }
+
+            if (kept.multipliers.empty()) {
+                ++report.droppedTables;
+                continue;
+            }
+
+            report.keptTerms += kept.multipliers.size();
+
+            rebuildTail(kept);
+
+            ++result.data.tableCount[kept.variable];
+            result.data.tables.push_back(std::move(kept));
+        }
+
+        result.report = report;
+
+        return result;
+    }
+
+    std::size_t truncation(const CompiledTable& table, const double t, const double tolerance) {
+        const auto size = table.multipliers.size();
+
+        if (tolerance <= 0) return size;
+
+        const auto scale = binPow(std::abs(t), table.power);
+
+        if (scale == 0) return 0;
+
+        // tailAmplitude单调不增，找到第一个余项上界不超过容差的位置
+        const auto threshold = tolerance / scale;
+
+        return std::ranges::partition_point(table.tailAmplitude, [&](const double tail) { return tail > threshold; }) - table.tailAmplitude.begin();
+    }
+
+    double calcSeries(const std::array<double, 17>& revolution, const CompiledTable& table, const std::size_t count) {
+        double result{};
+
+        for (std::size_t i{}; i < count; ++i) {
+            double phi{};
+            for (std::size_t j{}; j < revolution.size(); ++j) phi += table.multipliers[i][j] * revolution[j];
+
+            const auto [sinPhi, cosPhi] = sincos(fraction(phi) * 2 * std::numbers::pi);
+
+            result += table.sinAmplitude[i] * sinPhi + table.cosAmplitude[i] * cosPhi;
+        }
+
+        return result;
+    }
+
+    std::tuple<double, double, double, double, double, double> calcCoefficents(const double t, const CompiledData& data, const double tolerance) {
+        return calcCoefficents(t, data, std::array<double, 6>{tolerance, tolerance, tolerance, tolerance, tolerance, tolerance});
+    }
+
+    std::tuple<double, double, double, double, double, double> calcCoefficents(const double t, const CompiledData& data, const std::array<double, 6>& tolerance) {
+        double series[6] = {0};
+
+        const auto tm = t / 10;
+
+        // 各基本幅角每个历元只约化一次
+        const auto revolution = fundamentalRevolutions(tm);
+
+        for (const auto& table : data.tables) {
+            // 容差在同一变量的各表之间平分
+            const auto count = truncation(table, tm, tolerance[table.variable] / data.tableCount[table.variable]);
+
+            series[table.variable] += binPow(tm, table.power) * calcSeries(revolution, table, count);
+        }
+
+        for (std::size_t i{}; i < data.polynomial.size(); ++i) series[i] += evalPolynomial(data.polynomial[i], tm - data.polynomialCenter);
+
+        return {series[0], series[1], series[2], series[3], series[4], series[5]};
+    }
+
+    void calcCoefficents(const double t0, const double step, const CompiledData& data, const std::span<std::array<double, 6>> coefficients, const double tolerance) {
+        if (step == 0 || !std::isfinite(step)) throw std::invalid_argument(std::format("calcCoefficents: step {} must be finite and non-zero", step));
+
+        std::ranges::fill(coefficients, std::array<double, 6>{});
+
+        if (coefficients.empty()) return;
+
+        const auto tm    = t0 / 10;
+        const auto stepm = step / 10;
+
+        // 截断按区间内|t|最大的端点确定，对整个序列都成立
+        const auto edge = std::max(std::abs(tm), std::abs(tm + (coefficients.size() - 1) * stepm));
+
+        // 基本幅角是t的线性函数，每步的周数增量恒定，二阶差分为0
+        std::array<double, 17> increment{};
+        for (std::size_t j{}; j < increment.size(); ++j) increment[j] = LAMBDA_COEFFICIENTS[j][1] * stepm / (2 * std::numbers::pi);
+
+        std::vector<double> phase, phaseIncrement, curvature;
+        PhaseRecurrence recurrence;
+
+        for (const auto& table : data.tables) {
+            const auto count = truncation(table, edge, tolerance / data.tableCount[table.variable]);
+
+            phase.resize(count), phaseIncrement.resize(count), curvature.assign(count, 0.0);
+
+            for (std::size_t i{}; i < count; ++i) {
+                double d{};
+                for (std::size_t j{}; j < increment.size(); ++j) d += table.multipliers[i][j] * increment[j];
+
+                phaseIncrement[i] = d;
+            }
+
+            for (std::size_t k{}; k < coefficients.size(); ++k) {
+                const auto t = tm + k * stepm;
+
+                if (k % RECURRENCE_ANCHOR_INTERVAL == 0) {
+                    const auto revolution = fundamentalRevolutions(t);
+
+                    for (std::size_t i{}; i < count; ++i) {
+                        double phi{};
+                        for (std::size_t j{}; j < revolution.size(); ++j) phi += table.multipliers[i][j] * revolution[j];
+
+                        phase[i] = phi;
+                    }
+
+                    recurrence.anchor(phase, phaseIncrement, curvature);
+                }
+                else
+                    recurrence.advance();
+
+                const auto sinPhi = recurrence.sin();
+                const auto cosPhi = recurrence.cos();
+
+                double result{};
+                for (std::size_t i{}; i < count; ++i) result += table.sinAmplitude[i] * sinPhi[i] + table.cosAmplitude[i] * cosPhi[i];
+
+                coefficients[k][table.variable] += binPow(t, table.power) * result;
+            }
+        }
+
+        for (std::size_t k{}; k < coefficients.size(); ++k)
+            for (std::size_t i{}; i < data.polynomial.size(); ++i) coefficients[k][i] += evalPolynomial(data.polynomial[i], tm + k * stepm - data.polynomialCenter);
+    }
+
+    namespace {
+        template<typename Policy>
+            requires validationPolicy<Policy>
+        GeoCoord<double, double, double> elementsToSpherical(const double a, const double l, const double k, const double h, const double q, const double p) {
+            // rangeCheck(a, 0.3, 40 * AU);
+            // rangeCheck(l, 0.0, 2 * std::numbers::pi);
+            // rangeCheck(k, -0.3, 0.3);
+            // rangeCheck(h, -0.3, 0.3);
+            // rangeCheck(p, -0.25, 0.25);
+            // rangeCheck(q, -0.25, 0.25);
+
+            // 偏心率(e)
+            auto eccentricity = calcEccentricity(k, h);
+            validate<Policy>(eccentricity, 0.0, 0.5);
+
+            // 近日点黄经(\Pi)
+            auto perihelionLongitude = calcPerihelionLongitude(k, h);
+            validate<Policy>(perihelionLongitude, -std::numbers::pi, std::numbers::pi);
+
+            // 平近点角(M)，l为不归约的平经度，先归约到[0, 2π)
+            auto meanAnomaly = std::fmod(calcMeanAnomaly(l, perihelionLongitude), 2 * std::numbers::pi);
+            if (meanAnomaly < 0) meanAnomaly += 2 * std::numbers::pi;
+            validate<Policy>(meanAnomaly, 0.0, 2 * std::numbers::pi);
+
+            // 轨道倾角(i)
+            auto orbitInclination = calcOrbitInclination(q, p);
+            validate<Policy>(orbitInclination, 0.0, 0.6);
+
+            // 升交点黄经(\Omega)
+            auto ascendingNodeLongitude = calcAscendingNodeLongitude(q, p);
+            validate<Policy>(ascendingNodeLongitude, -std::numbers::pi, std::numbers::pi);
+
+            // 偏近点角(E)
+            auto eccentricAnomaly = solveKepler(eccentricity, meanAnomaly);
+            validate<Policy>(eccentricAnomaly, -std::numbers::pi, std::numbers::pi);
+
+            // 真近点角(\nu)
+            auto trueAnomaly = calcTrueAnomaly(eccentricAnomaly, eccentricity);
+            validate<Policy>(trueAnomaly, -std::numbers::pi, std::numbers::pi);
+
+            // 日心距(r)
+            auto heliocentricDistance = calcHeliocentricDistance(a, eccentricity, trueAnomaly);
+            validate<Policy>(heliocentricDistance, a * (1 - eccentricity), a * (1 + eccentricity));
+
+            // 升交点起算的纬度幅角 u = ω + ν，其中近日点幅角 ω = ϖ - Ω
+            auto theta = perihelionLongitude - ascendingNodeLongitude + trueAnomaly;
+            auto x     = heliocentricDistance * (std::cos(ascendingNodeLongitude) * std::cos(theta) - std::sin(ascendingNodeLongitude) * std::sin(theta) * std::cos(orbitInclination));
+            auto y     = heliocentricDistance * (std::sin(ascendingNodeLongitude) * std::cos(theta) + std::cos(ascendingNodeLongitude) * std::sin(theta) * std::cos(orbitInclination));
+            auto z     = heliocentricDistance * std::sin(theta) * std::sin(orbitInclination);
+
+            auto V = std::atan2(-y, -x);
+            validate<Policy>(V, -std::numbers::pi, std::numbers::pi);
+            auto U = -std::asin(z / heliocentricDistance);
+            validate<Policy>(U, -orbitInclination, orbitInclination);
+
+            return {heliocentricDistance, V, U};
+        }
+    }  // namespace
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
     GeoCoord<double, double, double> vsop2013(double tdb_jd_C, const reader::Data& data) {
-        if (std::abs(tdb_jd_C) > 100) throw std::invalid_argument(std::format("The time {} exceeds the supported range of Vsop2013.", tdb_jd_C));
+        if constexpr (Policy::enabled)
+            if (std::abs(tdb_jd_C) > 100) throw std::invalid_argument(std::format("The time {} exceeds the supported range of Vsop2013.", tdb_jd_C));
+
+        const auto [a, l, k, h, q, p] = calcCoefficents<double>(tdb_jd_C, data);
+
+        return elementsToSpherical<Policy>(a, l, k, h, q, p);
+    }
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    GeoCoord<double, double, double> vsop2013(double tdb_jd_C, const CompiledData& data, double tolerance) {
+        if constexpr (Policy::enabled)
+            if (tdb_jd_C < data.validFrom || tdb_jd_C > data.validTo)
+                throw std::invalid_argument(std::format("The time {} exceeds the supported range of the compiled Vsop2013 series.", tdb_jd_C));
+
+        const auto [a, l, k, h, q, p] = calcCoefficents(tdb_jd_C, data, tolerance);
+
+        return elementsToSpherical<Policy>(a, l, k, h, q, p);
+    }
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    GeoCoord<double, double, double> vsop2013(double tdb_jd_C, const CompiledData& data, const std::array<double, 6>& tolerance) {
+        if constexpr (Policy::enabled)
+            if (tdb_jd_C < data.validFrom || tdb_jd_C > data.validTo)
+                throw std::invalid_argument(std::format("The time {} exceeds the supported range of the compiled Vsop2013 series.", tdb_jd_C));
+
+        const auto [a, l, k, h, q, p] = calcCoefficents(tdb_jd_C, data, tolerance);
+
+        return elementsToSpherical<Policy>(a, l, k, h, q, p);
+    }
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    void vsop2013(double tdb_jd_C, double step, const CompiledData& data, std::span<GeoCoord<double, double, double>> coordinates, double tolerance) {
+        if (coordinates.empty()) return;
+
+        if constexpr (Policy::enabled) {
+            const auto last = tdb_jd_C + (coordinates.size() - 1) * step;
+
+            if (std::min(tdb_jd_C, last) < data.validFrom || std::max(tdb_jd_C, last) > data.validTo)
+                throw std::invalid_argument(std::format("The time span [{}, {}] exceeds the supported range of Vsop2013.", tdb_jd_C, last));
+        }
+
+        std::vector<std::array<double, 6>> coefficients(coordinates.size());
+        calcCoefficents(tdb_jd_C, step, data, coefficients, tolerance);
+
+        for (std::size_t i{}; i < coordinates.size(); ++i) {
+            const auto [a, l, k, h, q, p] = coefficients[i];
+
+            coordinates[i] = elementsToSpherical<Policy>(a, l, k, h, q, p);
+        }
+    }
+
+    template GeoCoord<double, double, double> vsop2013<validation::Checked>(double tdb_jd_C, const reader::Data& data);
+
+    template GeoCoord<double, double, double> vsop2013<validation::DebugOnly>(double tdb_jd_C, const reader::Data& data);
+
+    template GeoCoord<double, double, double> vsop2013<validation::Unchecked>(double tdb_jd_C, const reader::Data& data);
 
-        const auto [a, l, k, h, p, q] = calcCoefficents<double>(tdb_jd_C, data);
-        // rangeCheck(a, 0.3, 40 * AU);
-        // rangeCheck(l, 0.0, 2 * std::numbers::pi);
-        // rangeCheck(k, -0.3, 0.3);
-        // rangeCheck(h, -0.3, 0.3);
-        // rangeCheck(p, -0.25, 0.25);
-        // rangeCheck(q, -0.25, 0.25);
+    template GeoCoord<double, double, double> vsop2013<validation::Checked>(double tdb_jd_C, const CompiledData& data, double tolerance);
 
-        // 偏心率(e)
-        auto eccentricity = calcEccentricity(k, h);
-        rangeCheck(eccentricity, 0.0, 0.5);
+    template GeoCoord<double, double, double> vsop2013<validation::DebugOnly>(double tdb_jd_C, const CompiledData& data, double tolerance);
 
-        // 近日点黄经(\Pi)
-        auto perihelionLongitude = calcPerihelionLongitude(k, h);
-        rangeCheck(perihelionLongitude, 0.0, 2 * std::numbers::pi);
+    template GeoCoord<double, double, double> vsop2013<validation::Unchecked>(double tdb_jd_C, const CompiledData& data, double tolerance);
 
-        // 平近点角(M)
-        auto meanAnomaly = calcMeanAnomaly(l, perihelionLongitude);
-        rangeCheck(meanAnomaly, 0.0, 2 * std::numbers::pi);
+    template GeoCoord<double, double, double> vsop2013<validation::Checked>(double tdb_jd_C, const CompiledData& data, const std::array<double, 6>& tolerance);
 
-        // 轨道倾角(i)
-        auto orbitInclination = calcOrbitInclination(q, p);
-        rangeCheck(orbitInclination, 0.0, 0.6);
+    template GeoCoord<double, double, double> vsop2013<validation::DebugOnly>(double tdb_jd_C, const CompiledData& data, const std::array<double, 6>& tolerance);
 
-        // 升交点黄经(\Omega)
-        auto ascendingNodeLongitude = calcAscendingNodeLongitude(q, p);
-        rangeCheck(ascendingNodeLongitude, 0.0, 2 * std::numbers::pi);
+    template GeoCoord<double, double, double> vsop2013<validation::Unchecked>(double tdb_jd_C, const CompiledData& data, const std::array<double, 6>& tolerance);
 
-        // 偏近点角(E)
-        auto eccentricAnomaly = calcKepler(meanAnomaly, eccentricity, meanAnomaly);
-        rangeCheck(eccentricAnomaly, 0.0, 2 * std::numbers::pi);
+    template void vsop2013<validation::Checked>(double tdb_jd_C, double step, const CompiledData& data, std::span<GeoCoord<double, double, double>> coordinates, double tolerance);
 
-        // 真近点角(\nu)
-        auto trueAnomaly = calcTrueAnomaly(eccentricAnomaly, eccentricity);
-        rangeCheck(trueAnomaly, 0.0, 2 * std::numbers::pi);
+    template void vsop2013<validation::DebugOnly>(double tdb_jd_C, double step, const CompiledData& data, std::span<GeoCoord<double, double, double>> coordinates, double tolerance);
 
-        // 日心距(r)
-        auto heliocentricDistance = calcHeliocentricDistance(a, eccentricity, trueAnomaly);
-        rangeCheck(heliocentricDistance, a * (1 - eccentricity), a * (1 + eccentricity));
+    template void vsop2013<validation::Unchecked>(double tdb_jd_C, double step, const CompiledData& data, std::span<GeoCoord<double, double, double>> coordinates, double tolerance);
 
-        auto theta = perihelionLongitude - trueAnomaly;
-        auto x     = heliocentricDistance * (std::cos(ascendingNodeLongitude) * std::cos(theta) - std::sin(ascendingNodeLongitude) * std::sin(theta) * std::cos(orbitInclination));
-        auto y     = heliocentricDistance * (std::sin(ascendingNodeLongitude) * std::cos(theta) + std::cos(ascendingNodeLongitude) * std::sin(theta) * std::cos(orbitInclination));
-        auto z     = heliocentricDistance * std::sin(theta) * std::sin(orbitInclination);
+    // VSOP2013.f: INPOP10A质量系统 (AU^3/day^2)
+    constexpr double GM_SUN = 2.9591220836841438269e-04;
 
-        auto V = std::atan2(-y, -x);
-        rangeCheck(V, 0.0, 2 * std::numbers::pi);
-        auto U = -std::asin(z / heliocentricDistance);
-        rangeCheck(U, -orbitInclination, orbitInclination);
+    constexpr std::array<double, 9> GM_PLANET = {4.9125474514508118699e-11, 7.2434524861627027000e-10, 8.9970116036316091182e-10,
+                                                 9.5495351057792580598e-11, 2.8253458420837780000e-07, 8.4597151856806587398e-08,
+                                                 1.2920249167819693900e-08, 1.5243589007842762800e-08, 2.1886997654259696800e-12};
 
-        return {heliocentricDistance, V, U};
+    int bodyIndex(const reader::Data& data) {
+        if (data.tables.empty()) throw std::invalid_argument("bodyIndex: data has no tables");
+
+        auto index = std::get<int>(dynamic_cast<reader::Integer*>(data.tables.front()->header->fields[1].get())->value());
+        rangeCheck(index, 1, 9);
+
+        return index;
     }
 
+    StateVector ellipticToRectangular(const double a, const double l, const double k, const double h, const double q, const double p, const double gm) {
+        // 同VSOP2013.f中的ELLXYZ，以偏近点经度F直接求位置与速度，不经过真近点角与球面坐标
+        const auto fi = std::sqrt(1 - k * k - h * h);
+        const auto ki = std::sqrt(1 - q * q - p * p);
+        const auto u  = 1 / (1 + fi);
+
+        const auto perihelionLongitude = calcPerihelionLongitude(k, h);
+        const auto F                   = solveKepler(calcEccentricity(k, h), calcMeanAnomaly(l, perihelionLongitude)) + perihelionLongitude;
+        const auto cosF = std::cos(F), sinF = std::sin(F);
+
+        const auto rsa = 1 - (k * cosF + h * sinF);
+        const auto im  = k * sinF - h * cosF;
+
+        const auto xcw = (cosF - k + u * im * h) / rsa;
+        const auto xsw = (sinF - h - u * im * k) / rsa;
+        const auto xm  = p * xcw - q * xsw;
+        const auto xr  = a * rsa;
+
+        const auto xms = a * (h + xsw) / fi;
+        const auto xmc = a * (k + xcw) / fi;
+        const auto xn  = std::sqrt(gm / a) / a;
+
+        return {
+            {xr * (xcw - 2 * p * xm), xr * (xsw + 2 * q * xm), -2 * xr * ki * xm},
+            {xn * ((2 * p * p - 1) * xms + 2 * p * q * xmc), xn * ((1 - 2 * q * q) * xmc - 2 * p * q * xms), 2 * xn * ki * (p * xms + q * xmc)}
+        };
+    }
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    StateVector vsop2013Rectangular(const double tdb_jd_C, const reader::Data& data, const Frame frame) {
+        if constexpr (Policy::enabled)
+            if (std::abs(tdb_jd_C) > 100) throw std::invalid_argument(std::format("The time {} exceeds the supported range of Vsop2013.", tdb_jd_C));
+
+        const auto [a, l, k, h, q, p] = calcCoefficents<double>(tdb_jd_C, data);
+        validate<Policy>(calcEccentricity(k, h), 0.0, 0.5);
+
+        auto state = ellipticToRectangular(a, l, k, h, q, p, GM_SUN + GM_PLANET[bodyIndex(data) - 1]);
+
+        return frame == Frame::EclipticJ2000 ? state : rotate(frameRotation(Frame::EclipticJ2000, frame, tdb_jd_C), state);
+    }
+
+    template<typename Policy>
+        requires validationPolicy<Policy>
+    void vsop2013Rectangular(std::span<const double> tdb_jd_C, const reader::Data& data, const Frame frame, std::span<StateVector> states) {
+        if (tdb_jd_C.size() != states.size()) throw std::invalid_argument("vsop2013Rectangular: span sizes do not match");
+
+        for (std::size_t i{}; i < tdb_jd_C.size(); ++i) states[i] = vsop2013Rectangular<Policy>(tdb_jd_C[i], data, Frame::EclipticJ2000);
+
+        switch (frame) {
+            case Frame::EclipticJ2000: break;
+            case Frame::ICRS: rotate(ECLIPTIC_TO_ICRS, states); break;
+            default: rotate(frameRotations(Frame::EclipticJ2000, frame, tdb_jd_C), states); break;
+        }
+    }
+
+    template StateVector vsop2013Rectangular<validation::Checked>(double tdb_jd_C, const reader::Data& data, Frame frame);
+
+    template StateVector vsop2013Rectangular<validation::DebugOnly>(double tdb_jd_C, const reader::Data& data, Frame frame);
+
+    template StateVector vsop2013Rectangular<validation::Unchecked>(double tdb_jd_C, const reader::Data& data, Frame frame);
+
+    template void vsop2013Rectangular<validation::Checked>(std::span<const double> tdb_jd_C, const reader::Data& data, Frame frame, std::span<StateVector> states);
+
+    template void vsop2013Rectangular<validation::DebugOnly>(std::span<const double> tdb_jd_C, const reader::Data& data, Frame frame, std::span<StateVector> states);
+
+    template void vsop2013Rectangular<validation::Unchecked>(std::span<const double> tdb_jd_C, const reader::Data& data, Frame frame, std::span<StateVector> states);
+
 }  // namespace astro::vsop
@@ -19,7 +19,11 @@
 
 #include "src/ast.h"
 #include "constant.h"
+#include "frame.h"
+#include "utils.h"
+#include <cstdint>
 #include <functional>
+#include <span>
 #include <vector>
 
 namespace astro::vsop {
@@ -59,12 +63,109 @@ namespace astro::vsop {
 
     extern const std::vector<std::function<double(double)>> LAMBDA_TABLE;
 
+    ///< λ_i(t) = c0 + c1·t (弧度，t为儒略千年)，顺序同LAMBDA_TABLE
+    extern const std::array<std::array<double, 2>, 17> LAMBDA_COEFFICIENTS;
+
+    ///< 各基本幅角在t时刻的周数，约化到[0, 1)
+    std::array<double, 17> fundamentalRevolutions(double t);
+
     double calcPhi(double t, const std::vector<std::shared_ptr<reader::Literal>>& data);
 
-    double calcSeries(double t, const std::shared_ptr<Term>& term);
+    double calcSeries(double t, const std::shared_ptr<reader::Term>& term);
+
+    struct CompiledTable {
+        ///< 0~5依次对应a, l, k, h, q, p
+        int variable;
+        ///< 该表各项乘以t的幂次
+        int power;
+
+        ///< 17个基本幅角的整数乘数，顺序同LAMBDA_TABLE
+        std::vector<std::array<std::int32_t, 17>> multipliers;
+        std::vector<double> sinAmplitude;
+        std::vector<double> cosAmplitude;
+
+        ///< tailAmplitude[i]为第i项及其后所有项振幅之和，末尾多一个0
+        std::vector<double> tailAmplitude;
+    };
+
+    struct CompiledData {
+        std::vector<CompiledTable> tables;
+
+        ///< 每个变量对应的表数
+        std::array<int, 6> tableCount{};
+
+        ///< 窗口编译时由长周期项折成的多项式修正，按(t - polynomialCenter)升幂排列，t为儒略千年
+        std::array<std::vector<double>, 6> polynomial{};
+        double polynomialCenter{};
+
+        ///< 有效时间范围(儒略世纪)
+        double validFrom = -100;
+        double validTo   = 100;
+    };
+
+    CompiledData compile(const reader::Data& data);
+
+    ///< 窗口编译中长周期项折成的泰勒多项式次数
+    extern const int WINDOW_TAYLOR_DEGREE;
+
+    struct WindowReport {
+        ///< 各根数在窗口内的误差上界: 舍去项的振幅与折叠项的泰勒余项逐项相加，由三角不等式保证
+        std::array<double, 6> maxError{};
+
+        std::size_t originalTerms{};
+        std::size_t keptTerms{};
+        ///< 折入多项式的项数
+        std::size_t foldedTerms{};
+        std::size_t droppedTerms{};
+        ///< 全部项都被舍去或折叠的表数
+        std::size_t droppedTables{};
+    };
+
+    struct WindowCompilation {
+        CompiledData data;
+        WindowReport report;
+    };
+
+    /**
+     * @brief 针对时间窗口[t0, t1](儒略世纪)编译级数
+     * @details 窗口内|ω|·半宽很小的长周期项展开为泰勒多项式，贡献可忽略的项(含整张高次t^n表)直接舍去。
+     *          每个根数的误差预算为tolerance，按误差上界从小到大贪心选取，结果只在窗口内有效
+     * @throw std::invalid_argument 窗口为空或超出VSOP2013的有效范围
+     * */
+    WindowCompilation compile(const reader::Data& data, double t0, double t1, double tolerance);
+
+    std::size_t truncation(const CompiledTable& table, double t, double tolerance);
 
+    double calcSeries(const std::array<double, 17>& revolution, const CompiledTable& table, std::size_t count);
+
+    std::tuple<double, double, double, double, double, double> calcCoefficents(double t, const CompiledData& data, double tolerance = 0);
+
+    ///< 各根数分别指定截断容差，顺序为a, l, k, h, q, p
+    std::tuple<double, double, double, double, double, double> calcCoefficents(double t, const CompiledData& data, const std::array<double, 6>& tolerance);
+
+    /**
+     * @brief 等步长时间序列t0 + k·step (k = 0..N-1)上的六个根数，N为输出长度
+     * @details 相邻历元间各项幅角的增量恒定，以三角递推代替逐点求值，每RECURRENCE_ANCHOR_INTERVAL步重新锚定
+     * @throw std::invalid_argument step为0或非有限值
+     * */
+    void calcCoefficents(double t0, double step, const CompiledData& data, std::span<std::array<double, 6>> coefficients, double tolerance = 0);
+
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
     GeoCoord<double, double, double> vsop2013(double tdb_jd_C, const reader::Data& data);
 
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    GeoCoord<double, double, double> vsop2013(double tdb_jd_C, const CompiledData& data, double tolerance = 0);
+
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    GeoCoord<double, double, double> vsop2013(double tdb_jd_C, const CompiledData& data, const std::array<double, 6>& tolerance);
+
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    void vsop2013(double tdb_jd_C, double step, const CompiledData& data, std::span<GeoCoord<double, double, double>> coordinates, double tolerance = 0);
+
     double calcEccentricity(double k, double h);
 
     double calcPerihelionLongitude(double k, double h);
@@ -81,12 +182,35 @@ namespace astro::vsop {
 
     double diffKepler(double x, double eccentricity);
 
+    extern const int KEPLER_ITERATIONS;
+
+    double solveKepler(double eccentricity, double meanAnomaly);
+
+    void solveKepler(std::span<const double> eccentricity, std::span<const double> meanAnomaly, std::span<double> eccentricAnomaly);
+
     double calcTrueAnomaly(double eccentricAnomaly, double eccentricity);
 
     double calcHeliocentricDistance(double a, double eccentricity, double trueAnomaly);
 
     template<typename T>
     extern std::tuple<T, T, T, T, T, T> calcCoefficents(double t, const reader::Data& data);
+
+    extern const double GM_SUN;
+
+    extern const std::array<double, 9> GM_PLANET;
+
+    int bodyIndex(const reader::Data& data);
+
+    ///< 根数按VSOP2013级数的顺序a, l, k, h, q, p给出，同VSOP2013.f中ELLXYZ的v(1)~v(6)
+    StateVector ellipticToRectangular(double a, double l, double k, double h, double q, double p, double gm);
+
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    StateVector vsop2013Rectangular(double tdb_jd_C, const reader::Data& data, Frame frame = Frame::EclipticJ2000);
+
+    template<typename Policy = DefaultValidation>
+        requires validationPolicy<Policy>
+    void vsop2013Rectangular(std::span<const double> tdb_jd_C, const reader::Data& data, Frame frame, std::span<StateVector> states);
 }  // namespace astro::vsop
 
 
@@ -9,11 +9,25 @@
 
 #include "src/lexer.h"
 #include "src/parser.h"
+#include "../src/cache.h"
+#include "../src/catalog.h"
+#include "../src/lunar.h"
 #include "../src/main.h"
+#include "../src/pool.h"
+#include "../src/trig.h"
 #include "../src/utils.h"
 #include "../src/vsop.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <numbers>
+#include <string>
+#include <thread>
+#include <vector>
 
 astro::reader::Data parse(const std::string& content) {
     auto tokens = astro::reader::Lexer::tokenize(content);
@@ -21,6 +35,135 @@ astro::reader::Data parse(const std::string& content) {
     return astro::reader::Parser(tokens).parse();
 }
 
+// 地月系的合成根数: 平经度线性增长，q、p取较大的值使轨道面明显倾斜
+const std::string INCLINED_VSOP = R"( VSOP2013  3  1  0  1    EARTH-MOON VARIABLE A   *T*00
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00  0.1000001017800000 +01
+ VSOP2013  3  2  0  1    EARTH-MOON VARIABLE L   *T*00
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00  0.1753470459500000 +01
+ VSOP2013  3  2  1  1    EARTH-MOON VARIABLE L   *T*01
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00  0.6283075849991400 +04
+ VSOP2013  3  3  0  1    EARTH-MOON VARIABLE K   *T*00
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00 -0.3740816500000000 -02
+ VSOP2013  3  4  0  1    EARTH-MOON VARIABLE H   *T*00
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00  0.1628459180000000 -01
+ VSOP2013  3  5  0  1    EARTH-MOON VARIABLE Q   *T*00
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00  0.5000000000000000 -01
+ VSOP2013  3  6  0  1    EARTH-MOON VARIABLE P   *T*00
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00 -0.8000000000000000 -01
+)";
+const std::string PERTURBED_VSOP = R"( VSOP2013  3  1  0  3    EARTH-MOON VARIABLE A   *T*00
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00  0.1000001017800000 +01
+    2 0 0 1 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.1500000000000000 -04 -0.8000000000000000 -05
+    3 0 0 0 0 1 0 0 0 0 0 0 0 0 0 0 0 0  0.2000000000000000 -03  0.1000000000000000 -03
+ VSOP2013  3  2  0  3    EARTH-MOON VARIABLE L   *T*00
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00  0.1753470459500000 +01
+    2 0 0 0 0 1 0 0 0 0 0 0 0 0 0 0 0 0  0.3000000000000000 -03 -0.4000000000000000 -03
+    3 0 0 1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 -0.2000000000000000 -05  0.3500000000000000 -05
+ VSOP2013  3  2  1  1    EARTH-MOON VARIABLE L   *T*01
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00  0.6283075849991400 +04
+ VSOP2013  3  3  0  3    EARTH-MOON VARIABLE K   *T*00
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00 -0.3740816500000000 -02
+    2 0 0 0 0 1 0 0 0 0 0 0 0 0 0 0 0 0  0.1500000000000000 -03  0.2000000000000000 -03
+    3 0 0 1 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.2000000000000000 -04 -0.1000000000000000 -04
+ VSOP2013  3  4  0  3    EARTH-MOON VARIABLE H   *T*00
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00  0.1628459180000000 -01
+    2 0 0 0 0 1 0 0 0 0 0 0 0 0 0 0 0 0 -0.2000000000000000 -03  0.1500000000000000 -03
+    3 0 0 1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 -0.1000000000000000 -04  0.2000000000000000 -04
+ VSOP2013  3  5  0  2    EARTH-MOON VARIABLE Q   *T*00
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00  0.5000000000000000 -01
+    2 0 0 1 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.1000000000000000 -05  0.0000000000000000 +00
+ VSOP2013  3  6  0  2    EARTH-MOON VARIABLE P   *T*00
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00 -0.8000000000000000 -01
+    2 0 0 1 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00  0.1000000000000000 -05
+)";
+
+// 带周期项的合成级数: 平经度含三个短周期项、一个冥王星的长周期项和一个极小项，k含一个T^1的周期项，
+// 用于检验等步长递推与窗口编译
+const std::string PERIODIC_VSOP = R"( VSOP2013  3  1  0  1    EARTH-MOON VARIABLE A   *T*00
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00  0.1000001017800000 +01
+ VSOP2013  3  2  0  6    EARTH-MOON VARIABLE L   *T*00
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00  0.1753470459500000 +01
+    2 0 0 1 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.3341656456000000 -01 -0.2066011000000000 -03
+    3 0 0 2 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.3489427500000000 -03  0.1234567000000000 -04
+    4 0 0 0 0 1 0 0 0 0 0 0 0 0 0 0 0 0 -0.2000000000000000 -05  0.3500000000000000 -05
+    5 0 0 0 0 0 0 0 0 0 0 0 0 0 1 0 0 0  0.1000000000000000 -05  0.2000000000000000 -05
+    6 0 0 3 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.5000000000000000 -09  0.0000000000000000 +00
+ VSOP2013  3  2  1  1    EARTH-MOON VARIABLE L   *T*01
+    1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.0000000000000000 +00  0.6283075849991400 +04
+ VSOP2013  3  3  1  1    EARTH-MOON VARIABLE K   *T*01
+    1 0 0 1 0 0 0 0 0 0 0 0 0 0 0 0 0 0  0.1200000000000000 -03 -0.4500000000000000 -04
+)";
+
+// 合成的LEA-406表: 振幅跨越多个数量级、正负相消，count行，首项振幅为scale
+std::string syntheticLea(int count, double scale) {
+    std::string content;
+
+    for (int i{}; i < count; ++i) {
+        content += std::to_string(i + 1);
+
+        for (int j{}; j < 14; ++j) content += " " + std::to_string((i * (j + 3) + j) % 5 - 2);
+
+        const auto amplitude = scale * std::pow(10.0, -(i % 9)) * std::sin(i * 0.37 + 0.1);
+
+        for (const auto a : {amplitude, amplitude * 1e-3, amplitude * 1e-5}) content += " " + std::to_string(a);
+
+        for (int j{}; j < 3; ++j) content += " " + std::to_string(std::fmod(i * 37.1 + j * 113.7, 360.0) - 180);
+
+        content += "\n";
+    }
+
+    return content;
+}
+
+void validation_test() {
+    using namespace astro;
+
+    const auto data = parse(INCLINED_VSOP);
+
+    // 严格检查下，有效时间范围内的合法输入不应触发任何范围检查
+    int failures{};
+
+    for (int i{}; i < 2000; ++i) try {
+            vsop::vsop2013<validation::Checked>(-100 + i * 0.1 + 0.037, data);
+        } catch (const std::out_of_range&) { ++failures; }
+
+    std::cout << "Checked Range Failures: " << failures << std::endl;
+}
+
+void rectangular_test() {
+    using namespace astro;
+
+    const auto data = parse(INCLINED_VSOP);
+
+    // 球面坐标为地心的太阳，取反即为日心的地月系质心
+    double maxError{};
+
+    for (int i{}; i < 200; ++i) {
+        const auto t = -100 + i + 0.37;
+
+        const auto [r, longitude, latitude] = vsop::vsop2013<validation::Checked>(t, data);
+        const auto position                 = vsop::vsop2013Rectangular<validation::Checked>(t, data).position;
+
+        const Vector3 expected{-r * std::cos(latitude) * std::cos(longitude), -r * std::cos(latitude) * std::sin(longitude), -r * std::sin(latitude)};
+
+        for (std::size_t k{}; k < 3; ++k) maxError = std::max(maxError, std::abs(position[k] - expected[k]));
+    }
+
+    // 轨道面法向由q = sin(i/2)cosΩ、p = sin(i/2)sinΩ独立给出: (sin i sinΩ, -sin i cosΩ, cos i)
+    const auto [position, velocity] = vsop::vsop2013Rectangular<validation::Checked>(0.25, data);
+
+    const Vector3 momentum{position[1] * velocity[2] - position[2] * velocity[1], position[2] * velocity[0] - position[0] * velocity[2], position[0] * velocity[1] - position[1] * velocity[0]};
+    const auto norm = std::hypot(momentum[0], momentum[1], momentum[2]);
+
+    const double q = 0.05, p = -0.08, ki = std::sqrt(1 - q * q - p * p);
+    const Vector3 normal{2 * p * ki, -2 * q * ki, 1 - 2 * (q * q + p * p)};
+
+    double normalError{};
+    for (std::size_t k{}; k < 3; ++k) normalError = std::max(normalError, std::abs(momentum[k] / norm - normal[k]));
+
+    std::cout << "Rectangular Max Error: " << maxError << " Normal Error: " << normalError << std::endl;
+}
+
 void brent_test() {
     const auto func = [](double x) { return x * x - 2 * x + 1; };
 
@@ -29,6 +172,785 @@ void brent_test() {
     std::cout << "Brent Result: " << result << std::endl;
 }
 
+void kepler_test() {
+    using namespace astro;
+
+    std::vector<double> eccentricity, meanAnomaly;
+
+    for (int i{}; i < 100; ++i)
+        for (int j{}; j < 100; ++j) {
+            eccentricity.push_back(i * 0.0099);
+            meanAnomaly.push_back(-10 + j * 0.2);
+        }
+
+    std::vector<double> eccentricAnomaly(meanAnomaly.size());
+
+    vsop::solveKepler(eccentricity, meanAnomaly, eccentricAnomaly);
+
+    double maxResidual{};
+
+    for (std::size_t i{}; i < meanAnomaly.size(); ++i) {
+        auto residual = std::remainder(vsop::equationKepler(eccentricAnomaly[i], eccentricity[i], meanAnomaly[i]), 2 * std::numbers::pi);
+        maxResidual   = std::max(maxResidual, std::abs(residual));
+    }
+
+    std::cout << "Kepler Max Residual: " << maxResidual << std::endl;
+}
+
+void summation_test() {
+    using namespace astro;
+
+    std::vector<double> values;
+
+    // 跨越多个数量级且正负相消的项，近似月球级数的振幅分布
+    for (int i{}; i < 10000; ++i) values.push_back(std::pow(10.0, 5 - i % 12) * std::sin(i * 0.37));
+
+    long double reference{};
+
+    for (const auto x : values) reference += x;
+
+    std::cout << "Neumaier Sum Error: " << static_cast<double>(neumaierSum(values) - reference) << std::endl;
+    std::cout << "Blocked Sum Error: " << static_cast<double>(blockedSum(values) - reference) << std::endl;
+}
+
+void lea_summation_test() {
+    using namespace astro;
+
+    const auto model = lea::compile(parse(syntheticLea(3000, 20000)), parse(syntheticLea(3000, 20000)), parse(syntheticLea(3000, 18000)), lea::Model::Simplified);
+
+    double distanceError{}, longitudeError{}, latitudeError{};
+
+    // 406b的有效范围[-50, 10]世纪，double结果只做补偿累加，与long double逐项累加比较
+    for (int i{}; i <= 600; ++i) {
+        const auto t = -50 + i * 0.1;
+
+        const auto reference = lea::lea406<validation::Checked>(t, model);
+
+        for (const auto summation : {Summation::Neumaier, Summation::Blocked}) {
+            const auto coordinate = lea::lea406<validation::Checked, double>(t, model, 0, summation);
+
+            distanceError  = std::max(distanceError, std::abs(coordinate.geocentricDistance - static_cast<double>(reference.geocentricDistance)));
+            longitudeError = std::max(longitudeError, std::abs(coordinate.longitude - static_cast<double>(reference.longitude)) * 3600);
+            latitudeError  = std::max(latitudeError, std::abs(coordinate.latitude - static_cast<double>(reference.latitude)) * 3600);
+        }
+    }
+
+    // LEA-406b自身的精度约1m，相应角度约5e-4角秒
+    std::cout << "Double Summation Max Error: " << distanceError << " km " << longitudeError << "\" " << latitudeError << "\"" << std::endl;
+    std::cout << "Double Summation Within LEA-406 Precision: " << (distanceError < 1e-3 && longitudeError < 1e-4 && latitudeError < 1e-4) << std::endl;
+
+    bool rejected{};
+
+    try {
+        lea::calcSeries<lea::Trig::Sin, double>(0, model.vSeries, 0, Summation::LongDouble);
+    } catch (const std::invalid_argument&) { rejected = true; }
+
+    std::cout << "Double LongDouble Summation Throws: " << rejected << std::endl;
+}
+
+void sincos_test() {
+    using namespace astro;
+
+    const auto ulp = [](double value, double reference) { return std::abs(value - reference) / (std::nextafter(std::abs(reference), INFINITY) - std::abs(reference)); };
+
+    double maxUlp{};
+
+    // 覆盖VSOP2013/LEA-406有效时间范围内级数相位的量级
+    for (int i{}; i < 1000000; ++i) {
+        const auto x         = (i - 500000) * (SINCOS_MAX_ARGUMENT / 500000) + i * 1e-7;
+        const auto [sin, cos] = sincos(x);
+
+        maxUlp = std::max({maxUlp, ulp(sin, std::sin(x)), ulp(cos, std::cos(x))});
+    }
+
+    std::cout << "Sincos Max Ulp: " << maxUlp << " (documented " << SINCOS_MAX_ULP << ")" << std::endl;
+}
+
+void recurrence_test() {
+    using namespace astro;
+
+    // 二次相位 φ_k = φ_0 + k·d1 + k(k-1)/2·d2 (周)
+    const std::vector<double> phase{0.125, 37.7, -12.3}, step{0.0271, -3.9137, 0.5003}, curvature{0.0, 1e-9, -4e-8};
+
+    PhaseRecurrence recurrence;
+    recurrence.anchor(phase, step, curvature);
+
+    double maxError{};
+
+    for (std::size_t k{}; k < RECURRENCE_ANCHOR_INTERVAL; ++k) {
+        if (k) recurrence.advance();
+
+        for (std::size_t i{}; i < phase.size(); ++i) {
+            const auto reference = 2 * std::numbers::pi * std::remainder(phase[i] + k * step[i] + k * (k - 1) / 2.0 * curvature[i], 1.0);
+
+            maxError = std::max({maxError, std::abs(recurrence.sin()[i] - std::sin(reference)), std::abs(recurrence.cos()[i] - std::cos(reference))});
+        }
+    }
+
+    std::cout << "Recurrence Max Error: " << maxError << std::endl;
+}
+
+void series_step_test() {
+    using namespace astro;
+
+    // VSOP: 200个历元跨过三次重新锚定，与逐点求值比较
+    const auto vsopData = vsop::compile(parse(PERIODIC_VSOP));
+
+    std::vector<std::array<double, 6>> coefficients(200);
+    vsop::calcCoefficents(-3.21, 0.0137, vsopData, coefficients);
+
+    double vsopError{};
+
+    for (std::size_t n{}; n < coefficients.size(); ++n) {
+        const auto [a, l, k, h, q, p]   = vsop::calcCoefficents(-3.21 + n * 0.0137, vsopData);
+        const std::array<double, 6> reference{a, l, k, h, q, p};
+
+        for (std::size_t i{}; i < reference.size(); ++i) vsopError = std::max(vsopError, std::abs(coefficients[n][i] - reference[i]));
+    }
+
+    // LEA: 步长0.0007世纪时锚定间隔为28步，100个历元跨过三次重新锚定
+    const auto leaSeries = lea::compile(parse(syntheticLea(500, 20000)));
+
+    std::vector<double> values(100);
+    lea::calcSeries<lea::Trig::Sin>(1.234, 0.0007, leaSeries, values);
+
+    double leaError{};
+
+    for (std::size_t k{}; k < values.size(); ++k) leaError = std::max(leaError, std::abs(values[k] - static_cast<double>(lea::calcSeries<lea::Trig::Sin>(1.234 + k * 0.0007, leaSeries))));
+
+    std::cout << "Step Series Max Error: VSOP " << vsopError << " LEA " << leaError << "\"" << std::endl;
+
+    int rejected{};
+
+    try {
+        vsop::calcCoefficents(0, 0, vsopData, coefficients);
+    } catch (const std::invalid_argument&) { ++rejected; }
+
+    try {
+        lea::calcSeries<lea::Trig::Sin>(0, 0, leaSeries, values);
+    } catch (const std::invalid_argument&) { ++rejected; }
+
+    std::cout << "Zero Step Rejected: " << rejected << std::endl;
+}
+
+void window_test() {
+    using namespace astro;
+
+    const auto data = parse(PERIODIC_VSOP);
+
+    // 十年的窗口内冥王星项与各常数项折入多项式，极小项舍去，其余短周期项保留
+    const auto [window, report] = vsop::compile(data, 0.2, 0.3, 1e-8);
+    const auto full             = vsop::compile(data);
+
+    std::array<double, 6> maxError{}, magnitude{};
+
+    for (int i{}; i <= 100; ++i) {
+        const auto t = 0.2 + i * 0.001;
+
+        const auto [a0, l0, k0, h0, q0, p0] = vsop::calcCoefficents(t, window);
+        const auto [a1, l1, k1, h1, q1, p1] = vsop::calcCoefficents(t, full);
+
+        const std::array<double, 6> error{a0 - a1, l0 - l1, k0 - k1, h0 - h1, q0 - q1, p0 - p1};
+
+        const std::array<double, 6> reference{a1, l1, k1, h1, q1, p1};
+
+        for (std::size_t j{}; j < error.size(); ++j) {
+            maxError[j]  = std::max(maxError[j], std::abs(error[j]));
+            magnitude[j] = std::max(magnitude[j], std::abs(reference[j]));
+        }
+    }
+
+    // 上界只计截断误差，另留出与根数量级相当的舍入余量
+    bool withinBound = true;
+    for (std::size_t j{}; j < maxError.size(); ++j) withinBound = withinBound && maxError[j] <= report.maxError[j] + 1e-14 * magnitude[j];
+
+    std::cout << "Window Terms: " << report.keptTerms << " kept " << report.foldedTerms << " folded " << report.droppedTerms << " dropped of " << report.originalTerms << std::endl;
+    std::cout << "Window Max Error: " << std::ranges::max(maxError) << " Within Bound: " << withinBound << std::endl;
+}
+
+void batch_elongation_test() {
+    using namespace astro;
+
+    const auto data    = vsop::compile(parse(INCLINED_VSOP));
+    const auto rSeries = lea::compile(parse(syntheticLea(40, 4000000)));
+    const auto vSeries = lea::compile(parse(syntheticLea(40, 2000)));
+    const auto uSeries = lea::compile(parse(syntheticLea(40, 1000)));
+
+    // 容差取第20项起的剩余上界在|t| = 10世纪处的值，|t|小于10的历元截断到20项以内，大于10的历元多取几项
+    const auto& tail       = vSeries.tailAmplitude[20];
+    const double precision = tail[0] + tail[1] + tail[2];
+
+    // 乱序且|t|跨过10世纪的历元
+    const std::vector<double> epochs{-20.3, 0.013, 4.71, -0.52, -13.07, 2.2, 0.4, -7.9};
+
+    // 级数: 按历元截断后与单历元求值只差舍入误差
+    std::vector<double> values(epochs.size());
+    lea::calcSeries<lea::Trig::Sin>(epochs, vSeries, values, {}, precision);
+
+    double seriesDifference{};
+
+    for (std::size_t l{}; l < epochs.size(); ++l)
+        seriesDifference = std::max(seriesDifference, std::abs(values[l] - lea::calcSeries<lea::Trig::Sin, double>(epochs[l], vSeries, precision)));
+
+    // 合朔: 批量求解与逐个求解在求解容差内一致
+    std::vector<double> roots(epochs.size());
+
+    findNextNewMoon(
+        epochs,
+        [&](std::span<const double> t, std::span<Elongation> elongation) { moonSunElongation<validation::Checked>(t, data, rSeries, vSeries, uSeries, elongation, precision); },
+        roots
+    );
+
+    double rootDifference{};
+
+    for (std::size_t l{}; l < epochs.size(); ++l) {
+        const auto root = findNextNewMoon(epochs[l], [&](double t) { return moonSunElongation<validation::Checked>(t, data, rSeries, vSeries, uSeries, precision); });
+
+        rootDifference = std::max(rootDifference, std::abs(roots[l] - root) * 36525 * 86400);
+    }
+
+    std::cout << "Batch Series Max Difference: " << seriesDifference << "\" New Moon: " << rootDifference << " s" << std::endl;
+}
+
+void composed_elongation_test() {
+    using namespace astro;
+
+    const auto data   = vsop::compile(parse(INCLINED_VSOP));
+    const auto series = lea::compile(parse(syntheticLea(1, 0)));
+
+    // 组合函数保存的是两个临时坐标函数的副本
+    const auto composed = composeElongation(
+        [&](double t) { return solarApparentCoordinate<validation::Checked>(t, data); },
+        [&](double t) { return moonApparentCoordinate<validation::Checked>(t, data, series, series, series); }
+    );
+
+    double valueDiff{}, rateDiff{};
+
+    for (int i = -20; i <= 20; ++i) {
+        const auto t     = 0.1 * i + 0.013;
+        const auto fused = moonSunElongation<validation::Checked>(t, data, series, series, series);
+        const auto other = composed(t);
+
+        valueDiff = std::max(valueDiff, std::abs(fused.value - other.value));
+        rateDiff  = std::max(rateDiff, std::abs(fused.rate / other.rate - 1));
+    }
+
+    // 两者的黄经差由同一套视坐标给出，应只差舍入；组合函数的速率取平均朔望速率，这里的月球只有平运动，只差太阳的中心差引起的千分之一量级
+    const bool within = valueDiff * 3600 < 1e-6 && rateDiff < 1e-2;
+
+    std::cout << "Composed Elongation Diff: " << valueDiff * 3600 << "\" Rate: " << rateDiff << " Within Tolerance: " << within << std::endl;
+}
+
+void longitude_component_test() {
+    using namespace astro;
+
+    // a、k、h以及R、U级数中都有振幅在CORRECTION_PRECISION上下的项，只求黄经时其中只用于修正的部分被截去
+    const auto data   = vsop::compile(parse(PERTURBED_VSOP));
+    const auto series = lea::compile(parse(syntheticLea(60, 1000)));
+
+    double solarDiff{}, moonDiff{};
+
+    for (int i = -20; i <= 20; ++i) {
+        const auto t = 0.1 * i + 0.013;
+
+        const auto solarAll       = solarApparentCoordinate<validation::Checked>(t, data, 0, Component::All);
+        const auto solarLongitude = solarApparentCoordinate<validation::Checked>(t, data, 0, Component::Longitude);
+        const auto moonAll        = moonApparentCoordinate<validation::Checked>(t, data, series, series, series, 0, Component::All);
+        const auto moonLongitude  = moonApparentCoordinate<validation::Checked>(t, data, series, series, series, 0, Component::Longitude);
+
+        solarDiff = std::max(solarDiff, std::abs(std::remainder(solarAll.longitude - solarLongitude.longitude, 360.0)));
+        moonDiff  = std::max(moonDiff, std::abs(std::remainder(static_cast<double>(moonAll.longitude - moonLongitude.longitude), 360.0)));
+    }
+
+    // CORRECTION_PRECISION引入的黄经误差小于0.001角秒
+    const bool within = solarDiff * 3600 < 1e-3 && moonDiff * 3600 < 1e-3;
+
+    std::cout << "Longitude Component Diff: Sun " << solarDiff * 3600 << "\" Moon " << moonDiff * 3600 << "\" Within Tolerance: " << within << std::endl;
+}
+
+void solar_term_test() {
+    using namespace astro;
+
+    const auto data = vsop::compile(parse(INCLINED_VSOP));
+
+    const auto solarCoord     = [&](double t) { return solarApparentCoordinate<validation::Checked>(t, data); };
+    const auto precisionCoord = [&](double t, double precision) { return solarApparentCoordinate<validation::Checked>(t, data, precision); };
+    const auto solarLong      = [&](double t) { return solarLongitude<validation::Checked>(t, data); };
+
+    // 坐标函数、两级求解与展开视黄经三种重载对同一节气给出同一时刻，交节时的视黄经等于termLongitude
+    double difference{}, longitudeError{};
+
+    for (const auto term : TERM_TABLE) {
+        const auto start = 0.2512;
+
+        const auto forward  = findSolarTermForward(start, term, solarLong);
+        const auto backward = findSolarTermBackward(start, term, solarLong);
+
+        for (const auto root : {findSolarTermForward(start, term, solarCoord), findSolarTermForward(start, term, precisionCoord, 1.0)})
+            difference = std::max(difference, std::abs(root - forward) * 36525 * 86400);
+
+        for (const auto root : {findSolarTermBackward(start, term, solarCoord), findSolarTermBackward(start, term, precisionCoord, 1.0)})
+            difference = std::max(difference, std::abs(root - backward) * 36525 * 86400);
+
+        longitudeError = std::max(longitudeError, std::abs(std::remainder(solarCoord(forward).longitude - termLongitude(term), 360.0)) * 3600);
+    }
+
+    std::cout << "Solar Term Overload Max Difference: " << difference << " s Longitude Error: " << longitudeError << "\"" << std::endl;
+}
+
+void refine_test() {
+    using namespace astro;
+
+    // 粗略模型x - 1与精确函数之差不超过0.01，其根1与斜率1作为两级求解的起点
+    int evaluations{};
+
+    const auto func = [&](double x) {
+        ++evaluations;
+        return x + 0.01 * std::sin(x) - 1;
+    };
+
+    const auto root = refineRoot(func, 1.0, 1.0, 0.02, 1e-12, 2);
+
+    std::cout << "Refine Result: " << root << " Residual: " << func(root) << " Evaluations: " << evaluations - 1 << std::endl;
+
+    // 无实根的函数在有限次扩展后放弃，而不是无限加倍半径
+    bool thrown{};
+
+    try {
+        refineRoot([](double x) { return x * x + 1; }, 0.0, 1.0, 0.1, 1e-12, 0);
+    } catch (const std::runtime_error&) { thrown = true; }
+
+    std::cout << "Unbracketable Refine Throws: " << thrown << std::endl;
+}
+
+void chained_refine_test() {
+    using namespace astro;
+
+    // 完整理论为平距角加一个周期摄动，粗略模型整体偏小半个envelope，完整理论下的合朔时刻粗略黄经差总在360k之下
+    constexpr double envelope = 0.01;
+
+    const auto fine = [](double t) -> Elongation {
+        return {lea::meanAngleDistance(t / 10) + 2 * std::sin(2 * std::numbers::pi * t * 36525 / 27.55), 360 / MEAN_LUNAR_MONTH * 36525};
+    };
+    const auto coarse = [&](double t) -> Elongation { return {fine(t).value - envelope / 2, fine(t).rate}; };
+
+    // 两级求解以自己的结果为下一次的起点，与只用完整理论的链逐次比较
+    double next = 0.2, prev = 0.2, expectedNext = 0.2, expectedPrev = 0.2, diff{};
+    int stuck{};
+
+    for (int i = 0; i < 40; ++i) {
+        const auto forward  = findNextNewMoon(next, coarse, fine, envelope);
+        const auto backward = findPrevNewMoon(prev, coarse, fine, envelope);
+
+        // 相邻两次合朔相隔约29.5天，不足一天即为重复求得了起点
+        stuck += (forward - next) * 36525 < 1;
+        stuck += (prev - backward) * 36525 < 1;
+
+        expectedNext = findNextNewMoon(expectedNext, fine);
+        expectedPrev = findPrevNewMoon(expectedPrev, fine);
+
+        diff = std::max({diff, std::abs(forward - expectedNext), std::abs(backward - expectedPrev)});
+
+        next = forward;
+        prev = backward;
+    }
+
+    std::cout << "Chained Refine Stuck: " << stuck << " of 80, Diff: " << diff * SECONDS_PER_CENTURY << " s" << std::endl;
+}
+
+void monotonic_test() {
+    using namespace astro;
+
+    struct Sample {
+        double value;
+        double rate;
+    };
+
+    // 与黄经差同类的单调函数: 平均运动加周期项
+    int evaluations{};
+
+    const auto func = [&](double x) {
+        ++evaluations;
+        return Sample{x + 0.1 * std::sin(3 * x), 1 + 0.3 * std::cos(3 * x)};
+    };
+
+    const auto root = solveMonotonic(func, 2.0, 2.0, 1e-12);
+
+    std::cout << "Monotonic Result: " << root << " Residual: " << root + 0.1 * std::sin(3 * root) - 2.0 << " Evaluations: " << evaluations << std::endl;
+
+    // 批量求解的每个根应与单独求解完全一致
+    const std::vector<double> target{-1.0, 0.5, 2.0, 7.25}, guess{-1.0, 0.5, 2.0, 7.25};
+    std::vector<double> roots(target.size());
+
+    const auto batch = [&](std::span<const double> x, std::span<Sample> samples) {
+        for (std::size_t i{}; i < x.size(); ++i) samples[i] = func(x[i]);
+    };
+
+    solveMonotonic<Sample>(batch, target, guess, roots, 1e-12);
+
+    double maxDifference{};
+
+    for (std::size_t i{}; i < target.size(); ++i) maxDifference = std::max(maxDifference, std::abs(roots[i] - solveMonotonic(func, target[i], guess[i], 1e-12)));
+
+    std::cout << "Batched Monotonic Max Difference: " << maxDifference << std::endl;
+}
+
+void cache_test() {
+    using namespace astro;
+
+    EpochCache<double> cache(256);
+
+    int evaluations{};
+
+    const auto compute = [&] {
+        ++evaluations;
+        return 1.5;
+    };
+
+    // 同一历元、精度、分量只求值一次，精度不同视为不同的键
+    for (int i = 0; i < 3; ++i) cache.get({0.25, 0, 0}, compute);
+
+    cache.get({0.25, 1, 0}, compute);
+
+    const auto statistics = cache.statistics();
+
+    std::cout << "Cache Evaluations: " << evaluations << " Hits: " << statistics.hits << " Misses: " << statistics.misses << " Capacity: " << cache.capacity() << std::endl;
+}
+
+void concurrent_cache_test() {
+    using namespace astro;
+
+    // 多字的值，四个分量都由键决定，读到写了一半的槽位时分量之间不再一致
+    struct Value {
+        double key, twice, thrice, square;
+    };
+
+    const auto expected = [](double key) { return Value{key, 2 * key, 3 * key, key * key}; };
+
+    // 容量远小于键数，写者之间频繁覆盖同一组的槽位
+    EpochCache<Value> cache(64, 2);
+
+    std::atomic<std::uint64_t> torn{}, hits{};
+
+    {
+        std::vector<std::jthread> threads;
+
+        for (int w{}; w < 4; ++w)
+            threads.emplace_back([&, w] {
+                for (int i{}; i < 200000; ++i) {
+                    const auto key = static_cast<double>((i * 7 + w * 131) % 1000);
+
+                    cache.insert({key, 0, 0}, expected(key));
+                }
+            });
+
+        for (int r{}; r < 4; ++r)
+            threads.emplace_back([&, r] {
+                for (int i{}; i < 200000; ++i) {
+                    const auto key = static_cast<double>((i * 13 + r * 17) % 1000);
+
+                    if (const auto value = cache.find({key, 0, 0})) {
+                        ++hits;
+
+                        const auto reference = expected(key);
+
+                        if (value->key != reference.key || value->twice != reference.twice || value->thrice != reference.thrice || value->square != reference.square) ++torn;
+                    }
+                }
+            });
+    }
+
+    std::cout << "Concurrent Cache Torn Reads: " << torn << " Hits: " << (hits > 0) << std::endl;
+
+    // 带缓存的月球视坐标经太阳缓存求太阳视黄经，此后同一历元的太阳查询直接命中
+    const auto data    = vsop::compile(parse(INCLINED_VSOP));
+    const auto rSeries = lea::compile(parse(syntheticLea(40, 4000000)));
+    const auto vSeries = lea::compile(parse(syntheticLea(40, 2000)));
+    const auto uSeries = lea::compile(parse(syntheticLea(40, 1000)));
+
+    MoonCoordinateCache moonCache(256);
+    SolarCoordinateCache solarCache(256);
+
+    const auto moon      = moonApparentCoordinate<validation::Checked>(0.25, data, rSeries, vSeries, uSeries, moonCache, solarCache);
+    const auto reference = moonApparentCoordinate<validation::Checked>(0.25, data, rSeries, vSeries, uSeries);
+
+    solarApparentCoordinate<validation::Checked>(0.25, data, solarCache);
+
+    const auto statistics = solarCache.statistics();
+
+    std::cout << "Moon Solar Cache Misses: " << statistics.misses << " Hits: " << statistics.hits << " Same: " << (moon.longitude == reference.longitude) << std::endl;
+}
+
+void event_stream_test() {
+    using namespace astro;
+
+    int pulled{};
+
+    // 平方数序列，取到第一个大于50的数即停止，之后的事件不会被求出
+    EventStream<int> squares([&pulled, n = 0]() mutable -> std::optional<int> {
+        ++pulled;
+        ++n;
+        return n * n;
+    });
+
+    int last{};
+    for (const auto square : squares) {
+        last = square;
+        if (square > 50) break;
+    }
+
+    std::cout << "Event Stream Last: " << last << " Pulled: " << pulled << std::endl;
+
+    const auto data   = vsop::compile(parse(INCLINED_VSOP));
+    const auto series = lea::compile(parse(syntheticLea(1, 0)));
+
+    const auto elongation = [&](double t) { return moonSunElongation<validation::Checked>(t, data, series, series, series); };
+    const auto solarLong  = [&](double t) { return solarLongitude<validation::Checked>(t, data); };
+
+    // 传入的临时函数对象在创建序列的语句结束时即销毁，序列使用的是自己保存的副本
+    auto moons = newMoonStream(0.0, [&](double t) { return elongation(t); }, 0.01);
+    auto terms = solarTermStream(0.0, [&](double t) { return solarLong(t); }, 0.01);
+
+    double moonDiff{}, termDiff{}, previous{};
+
+    for (const auto moment : moons) {
+        moonDiff = std::max(moonDiff, std::abs(moment - findNextNewMoon(previous, elongation)));
+        previous = moment;
+    }
+
+    previous = 0;
+
+    for (const auto& [term, moment] : terms) {
+        termDiff = std::max(termDiff, std::abs(moment - findSolarTermForward(previous, term, solarLong)));
+        previous = moment;
+    }
+
+    std::cout << "Stream Owned Functions Diff: " << moonDiff * SECONDS_PER_CENTURY << " s, " << termDiff * SECONDS_PER_CENTURY << " s" << std::endl;
+}
+
+void stealing_test() {
+    using namespace astro;
+
+    ThreadPool pool(3);
+
+    // 每个下标恰好执行一次，参与者编号可直接索引各自的计数而无需同步
+    std::vector<int> visits(1000);
+    std::vector<std::size_t> perParticipant(pool.size() + 1);
+
+    pool.stealingFor(visits.size(), [&](std::size_t i, std::size_t participant) {
+        ++visits[i];
+        ++perParticipant[participant];
+    });
+
+    std::size_t total{};
+    for (const auto count : perParticipant) total += count;
+
+    std::cout << "Stealing Once: " << std::ranges::all_of(visits, [](int n) { return n == 1; }) << " Total: " << total << std::endl;
+}
+
+void nested_pool_test() {
+    using namespace astro;
+
+    ThreadPool pool(2);
+
+    // 外层的每个参与者都占住一个工作线程并嵌套提交，等待中的线程须代为执行排队的内层参与者
+    std::vector<int> visits(64 * 64);
+
+    pool.parallelFor(64, [&](std::size_t i) { pool.stealingFor(64, [&](std::size_t j, std::size_t) { ++visits[i * 64 + j]; }); });
+
+    std::cout << "Nested Pool Once: " << std::ranges::all_of(visits, [](int n) { return n == 1; }) << std::endl;
+}
+
+void catalog_test() {
+    using namespace astro;
+
+    const auto path = std::filesystem::temp_directory_path() / "astro_catalog_test.cat";
+    std::filesystem::remove(path);
+
+    // 乱序写入，重新打开后并入有序区
+    {
+        EventCatalog catalog(path, 42);
+        catalog.insert(EventKind::SolarTerm, 3, 0.25);
+        catalog.insert(EventKind::NewMoon, 7, 0.5);
+        catalog.insert(EventKind::NewMoon, -2, 0.125);
+        catalog.insert(EventKind::NewMoon, 7, 1.0);
+    }
+
+    std::optional<double> found, missing;
+    std::size_t size{};
+    {
+        EventCatalog reopened(path, 42);
+        found   = reopened.find(EventKind::NewMoon, 7);
+        missing = reopened.find(EventKind::SolarTerm, 7);
+        size    = reopened.size();
+    }
+
+    // 标签不同的目录不被覆盖
+    bool rejected{};
+
+    try {
+        const EventCatalog other(path, 43);
+    } catch (const std::invalid_argument&) { rejected = true; }
+
+    std::size_t kept{};
+    {
+        const EventCatalog original(path, 42);
+        kept = original.size();
+    }
+
+    std::cout << "Catalog Size: " << size << " New Moon 7: " << found.value_or(-1) << " Missing: " << !missing << " Other Tag Rejected: " << rejected << " Kept: " << kept << std::endl;
+}
+
+void lunar_test() {
+    using namespace astro;
+
+    // 2023年(癸卯)前三个月，含闰二月
+    const auto start = [](int year, int month, int day) { return dayNumber({year, month, day, 0, 0, 0, UTC}); };
+
+    int builds{};
+
+    const auto build = [&](int year) {
+        ++builds;
+        return LunarYearTable{year, {{start(2023, 1, 22), 0, 1, false, Term::RainWater}, {start(2023, 2, 20), 0, 2, false, Term::SpringEquinox}, {start(2023, 3, 22), 0, 2, true, std::nullopt}}, start(2023, 4, 20)};
+    };
+
+    LunarYearCache cache(2);
+
+    const auto table = cache.get(2023, build);
+    cache.get(2023, build);
+
+    const auto lunarDate = table->toLunar({2023, 4, 1, 8, 0, 0, UTC});
+
+    // 容量为2，第三年写入时淘汰最久未用的一年
+    cache.get(2024, build);
+    cache.get(2025, build);
+    cache.get(2023, build);
+
+    std::cout << "Lunar Table: " << lunarDate.toString() << " Leap: " << lunarDate.isLeap << " Builds: " << builds << " Evictions: " << cache.statistics().evictions << std::endl;
+}
+
+void batch_lunar_test() {
+    using namespace astro;
+
+    // 只含平黄经的月球与开普勒运动的太阳，朔望月与中气的间隔接近真实值，同样会出现闰月
+    const auto data   = vsop::compile(parse(INCLINED_VSOP));
+    const auto series = lea::compile(parse(syntheticLea(1, 0)));
+
+    // 乱序的日期，覆盖正月初一可能所在的1月21日至2月20日窗口及其两侧
+    std::vector<DateTime> dates;
+
+    for (const auto& [month, day] : {std::pair{2, 25}, {1, 5}, {2, 20}, {12, 31}, {1, 21}, {6, 15}, {2, 3}, {1, 20}, {2, 21}, {1, 30}})
+        for (int year = 2025; year >= 2018; year -= 1) dates.push_back({year, month, day, (year * 7 + day) % 24, 30, 0, UTC});
+
+    const auto same = [](const LunarDate& lhs, const LunarDate& rhs) {
+        return lhs.year == rhs.year && lhs.month == rhs.month && lhs.day == rhs.day && lhs.isLeap == rhs.isLeap && lhs.hour == rhs.hour && lhs.minute == rhs.minute;
+    };
+
+    LunarYearCache scalarCache;
+    std::vector<LunarDate> expected;
+
+    for (const auto& date : dates) expected.push_back(gregorianToLunar<validation::Checked>(date, data, series, series, series, scalarCache));
+
+    ThreadPool pool(3);
+
+    std::size_t mismatches{};
+
+    for (auto* executor : {static_cast<ThreadPool*>(nullptr), &pool}) {
+        LunarYearCache cache;
+        std::vector<LunarDate> lunarDates(dates.size());
+
+        gregorianToLunar<validation::Checked>(dates, data, series, series, series, cache, lunarDates, executor);
+
+        for (std::size_t i{}; i < dates.size(); ++i) mismatches += !same(lunarDates[i], expected[i]);
+    }
+
+    std::cout << "Batch Lunar Mismatches: " << mismatches << " of " << 2 * dates.size() << std::endl;
+}
+
+void sweep_lunar_test() {
+    using namespace astro;
+    using namespace std::chrono;
+
+    const auto data   = vsop::compile(parse(INCLINED_VSOP));
+    const auto series = lea::compile(parse(syntheticLea(1, 0)));
+
+    // 跨过两个冬至，其间的农历年含一个闰月
+    constexpr year_month_day first{year{2022}, month{10u}, day{1}}, last{year{2024}, month{2u}, day{28}};
+
+    const auto toDateTime = [](const year_month_day& date) {
+        return DateTime{static_cast<int>(date.year()), static_cast<int>(static_cast<unsigned>(date.month())), static_cast<int>(static_cast<unsigned>(date.day())), 12, 0, 0, UTC};
+    };
+
+    std::vector<LunarDate> lunarDates(static_cast<std::size_t>((sys_days{last} - sys_days{first}).count() + 1));
+
+    sweepLunarCalendar<validation::Checked>(toDateTime(first), toDateTime(last), data, series, series, series, lunarDates);
+
+    LunarYearCache cache;
+    std::size_t mismatches{}, leapDays{};
+
+    for (std::size_t i{}; i < lunarDates.size(); ++i) {
+        const auto expected = gregorianToLunar<validation::Checked>(toDateTime(year_month_day{sys_days{first} + days{i}}), data, series, series, series, cache);
+        const auto& swept   = lunarDates[i];
+
+        mismatches += swept.year != expected.year || swept.month != expected.month || swept.day != expected.day || swept.isLeap != expected.isLeap;
+        leapDays += swept.isLeap;
+    }
+
+    std::cout << "Sweep Lunar Mismatches: " << mismatches << " of " << lunarDates.size() << ", Leap Days: " << leapDays << std::endl;
+}
+
+void precompute_lunar_test() {
+    using namespace astro;
+
+    const auto data   = vsop::compile(parse(INCLINED_VSOP));
+    const auto series = lea::compile(parse(syntheticLea(1, 0)));
+
+    constexpr int firstYear = 2018, lastYear = 2025;
+    constexpr auto count    = static_cast<std::size_t>(lastYear - firstYear + 1);
+
+    ThreadPool pool(3);
+
+    std::vector<std::pair<std::size_t, std::size_t>> reports;
+
+    const auto tables = precomputeLunarYears<validation::Checked>(firstYear, lastYear, data, series, series, series, pool, [&](std::size_t done, std::size_t total) {
+        reports.emplace_back(done, total);
+    });
+
+    // 与逐年建表逐月比较，复用的前一岁与重新求得的完全相同
+    std::size_t mismatches = tables.size() == count ? 0 : count;
+
+    for (std::size_t i{}; i < std::min(tables.size(), count); ++i) {
+        const auto expected = lunarYearTable<validation::Checked>(firstYear + static_cast<int>(i), data, series, series, series);
+        const auto& table   = tables[i];
+
+        mismatches += table.year != expected.year || table.end != expected.end ||
+                      !std::ranges::equal(table.months, expected.months, [](const LunarMonth& lhs, const LunarMonth& rhs) {
+                          return lhs.start == rhs.start && lhs.newMoon == rhs.newMoon && lhs.number == rhs.number && lhs.isLeap == rhs.isLeap && lhs.zhongqi == rhs.zhongqi;
+                      });
+    }
+
+    // 进度逐年加一，最后一次为count/count
+    bool monotonic = !reports.empty() && reports.back() == std::pair{count, count};
+
+    for (std::size_t i{}; i < reports.size(); ++i) monotonic = monotonic && reports[i] == std::pair{i + 1, count};
+
+    // 已请求停止时不开始任何年份；第一年完成后请求停止时，只有已开始的年份(每个参与线程至多一年)还会完成
+    std::stop_source stopped;
+    stopped.request_stop();
+
+    const auto none = precomputeLunarYears<validation::Checked>(firstYear, lastYear, data, series, series, series, pool, {}, stopped.get_token());
+
+    std::stop_source source;
+
+    const auto partial = precomputeLunarYears<validation::Checked>(
+        firstYear, lastYear, data, series, series, series, pool, [&](std::size_t, std::size_t) { source.request_stop(); }, source.get_token()
+    );
+
+    const bool early = none.empty() && !partial.empty() && partial.size() <= pool.size() + 1 && std::ranges::is_sorted(partial, {}, &LunarYearTable::year);
+
+    std::cout << "Precomputed Years Mismatches: " << mismatches << " of " << count << " Progress Monotonic: " << monotonic << " Stopped Early: " << early << std::endl;
+}
+
 void main_test() {
     using namespace astro;
 
@@ -80,6 +1002,32 @@ void main_run() {
 }
 
 int main() {
+    validation_test();
+    rectangular_test();
+    kepler_test();
+    summation_test();
+    lea_summation_test();
+    sincos_test();
+    recurrence_test();
+    series_step_test();
+    window_test();
+    batch_elongation_test();
+    composed_elongation_test();
+    longitude_component_test();
+    solar_term_test();
+    refine_test();
+    chained_refine_test();
+    monotonic_test();
+    cache_test();
+    concurrent_cache_test();
+    event_stream_test();
+    stealing_test();
+    nested_pool_test();
+    catalog_test();
+    lunar_test();
+    batch_lunar_test();
+    sweep_lunar_test();
+    precompute_lunar_test();
     main_run();
     return 0;
 }